@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+module lysa.ui.bindings;
+
+namespace lysa::ui {
+
+    Bindings::Handle Bindings::add(const std::shared_ptr<Widget>& widget, std::function<bool(Widget&)> update) {
+        bindings.push_back({nextHandle, widget, std::move(update)});
+        return nextHandle++;
+    }
+
+    void Bindings::unbind(const Handle handle) {
+        std::erase_if(bindings, [handle](const Binding& binding) { return binding.handle == handle; });
+    }
+
+    uint32 Bindings::update() {
+        auto updated = uint32{0};
+        // Index based, the widgets setters can add bindings
+        for (auto index = std::size_t{0}; index < bindings.size();) {
+            const auto widget = bindings[index].widget.lock();
+            if (!widget) {
+                bindings[index] = std::move(bindings.back());
+                bindings.pop_back();
+                continue;
+            }
+            if (bindings[index].update(*widget)) { updated += 1; }
+            index += 1;
+        }
+        return updated;
+    }
+
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+export module lysa.ui.bindings;
+
+import std;
+import lysa.types;
+import lysa.ui.check_widget;
+import lysa.ui.text;
+import lysa.ui.value_select;
+import lysa.ui.widget;
+
+export namespace lysa::ui {
+
+    /**
+     * Binds widgets to values of the application, see WindowManager::getBindings().
+     *
+     * The bound values are read once per frame, at the start of WindowManager::drawFrame(), and
+     * a widget is updated only when its value changed since the previous frame. The application
+     * can change its values any number of times per frame without any UI cost.
+     * ```
+     * ui.getBindings().bindText(healthText, [&]{ return player.health; }, "HP {}");
+     * ```
+     */
+    class Bindings {
+    public:
+        /**
+         * Binding identifier, to remove a binding.
+         */
+        using Handle = uint32;
+
+        /**
+         * Binds the text of a Text widget to a formatted value.
+         * @param text The widget.
+         * @param getter Function returning the value, any type usable with std::format.
+         * @param format Format string of the value, formatted into a buffer reused between frames.
+         */
+        template<typename Getter>
+        Handle bindText(const std::shared_ptr<Text>& text, Getter getter, std::string format = "{}") {
+            using Value = std::decay_t<std::invoke_result_t<Getter&>>;
+            return add(text, [getter = std::move(getter), format = std::move(format), last = std::optional<Value>{}, buffer = std::string{}]
+                (Widget& widget) mutable {
+                auto value = getter();
+                if (last && *last == value) { return false; }
+                buffer.clear();
+                std::vformat_to(std::back_inserter(buffer), format, std::make_format_args(value));
+                last = std::move(value);
+                static_cast<Text&>(widget).setText(buffer);
+                return true;
+            });
+        }
+
+        /**
+         * Binds the value of a ValueSelect widget (scroll bars, ...).
+         * @param valueSelect The widget.
+         * @param getter Function returning the value.
+         */
+        template<typename Getter>
+        Handle bindValue(const std::shared_ptr<ValueSelect>& valueSelect, Getter getter) {
+            // Compared with the last bound value, the widget clamps its value to its range
+            return add(valueSelect, [getter = std::move(getter), last = std::optional<float>{}](Widget& widget) mutable {
+                const auto value = static_cast<float>(getter());
+                if (last && *last == value) { return false; }
+                last = value;
+                static_cast<ValueSelect&>(widget).setValue(value);
+                return true;
+            });
+        }
+
+        /**
+         * Binds the state of a CheckWidget (check boxes, toggle buttons).
+         * @param checkWidget The widget.
+         * @param getter Function returning true for the CheckWidget::CHECK state.
+         */
+        template<typename Getter>
+        Handle bindState(const std::shared_ptr<CheckWidget>& checkWidget, Getter getter) {
+            return add(checkWidget, [getter = std::move(getter)](Widget& widget) {
+                auto& target = static_cast<CheckWidget&>(widget);
+                const auto state = getter() ? CheckWidget::CHECK : CheckWidget::UNCHECK;
+                if (target.getState() == state) { return false; }
+                target.setState(state);
+                return true;
+            });
+        }
+
+        /**
+         * Removes a binding.
+         */
+        void unbind(Handle handle);
+
+        /**
+         * Reads all the bound values and updates the widgets whose value changed.
+         * Bindings of destroyed widgets are removed.
+         * @return The number of updated widgets.
+         */
+        uint32 update();
+
+        /**
+         * Returns the number of bindings.
+         */
+        auto getSize() const { return bindings.size(); }
+
+    private:
+        struct Binding {
+            Handle handle;
+            std::weak_ptr<Widget> widget;
+            // Returns true if the widget was updated
+            std::function<bool(Widget&)> update;
+        };
+
+        std::vector<Binding> bindings;
+        Handle nextHandle{1};
+
+        Handle add(const std::shared_ptr<Widget>& widget, std::function<bool(Widget&)> update);
+    };
+
+}
@@ -23,7 +23,7 @@ namespace lysa::ui {
                 resizeChildren();
             } else {
                 Box::eventMouseUp(button, x, y);
-                ctx.events.push(Event{ UIEvent::OnClick, UIEventClick{}, id});
+                emit(UIEvent::OnClick, UIEventClick{});
                 return true;
             }
         }
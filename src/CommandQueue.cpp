@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+module lysa.ui.command_queue;
+
+namespace lysa::ui {
+
+    CommandQueue::~CommandQueue() {
+        while (const auto* node = pop()) {
+            delete node;
+        }
+    }
+
+    void CommandQueue::push(Node* node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        const auto previous = head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    CommandQueue::Node* CommandQueue::pop() {
+        auto* node = tail;
+        auto* next = node->next.load(std::memory_order_acquire);
+        if (node == &stub) {
+            if (next == nullptr) { return nullptr; }
+            tail = next;
+            node = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next != nullptr) {
+            tail = next;
+            return node;
+        }
+        if (node != head.load(std::memory_order_acquire)) {
+            // A producer is between the exchange & the link, the node will be available next time
+            return nullptr;
+        }
+        push(&stub);
+        next = node->next.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            tail = next;
+            return node;
+        }
+        return nullptr;
+    }
+
+    void CommandQueue::drain() {
+        pending.clear();
+        while (auto* node = pop()) {
+            pending.push_back(std::move(node->command));
+            delete node;
+        }
+        if (pending.empty()) { return; }
+
+        // Only the latest command of each widget setter is applied
+        applied.clear();
+        for (auto& command : std::views::reverse(pending)) {
+            if (command.key && !applied.insert({command.target, command.key}).second) {
+                command.apply = nullptr;
+            }
+        }
+        for (const auto& command : pending) {
+            if (command.apply) { command.apply(); }
+        }
+        pending.clear();
+    }
+
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+export module lysa.ui.command_queue;
+
+import std;
+
+export namespace lysa::ui {
+
+    /**
+     * Lock-free multiple producers, single consumer queue of widget updates.
+     *
+     * Any thread can post() commands, the UI thread applies them with drain(), usually
+     * once per frame from WindowManager::drawFrame(). When several commands target the same
+     * setter of the same widget, only the latest one is applied.
+     */
+    class CommandQueue {
+    public:
+        CommandQueue() = default;
+
+        ~CommandQueue();
+
+        CommandQueue(const CommandQueue&) = delete;
+        CommandQueue& operator=(const CommandQueue&) = delete;
+
+        /**
+         * Posts a call to a widget setter. Can be called from any thread.
+         *
+         * The widget is referenced weakly : the command is ignored if the widget is destroyed before being applied.
+         * @tparam setter The setter, for example `&Text::setText`.
+         * @param widget The target widget.
+         * @param args The setter arguments, copied into the command. The character arrays and pointers
+         * are copied as std::string, the caller's buffer can be released after the call.
+         */
+        template<auto setter, typename T, typename... Args>
+        void post(const std::shared_ptr<T>& widget, Args&&... args) {
+            push(new Node{.command = {
+                .target = widget.get(),
+                .key = &SETTER_KEY<setter>,
+                .apply = [weak = std::weak_ptr<T>(widget), ...args = Captured<Args>(std::forward<Args>(args))] {
+                    if (const auto target = weak.lock()) {
+                        ((*target).*setter)(args...);
+                    }
+                },
+            }});
+        }
+
+        /**
+         * Posts a function called by the UI thread. Can be called from any thread.
+         *
+         * Functions are never coalesced.
+         */
+        void post(std::function<void()> function) {
+            push(new Node{.command = {.apply = std::move(function)}});
+        }
+
+        /**
+         * Applies all the posted commands in the posting order, skipping the commands superseded by a later one.
+         * Must be called by a single thread.
+         */
+        void drain();
+
+    private:
+        // Type of a copied setter argument, the C strings are copied as std::string
+        template<typename Arg>
+        using Captured = std::conditional_t<
+            std::is_pointer_v<std::decay_t<Arg>> &&
+            std::is_same_v<std::remove_cv_t<std::remove_pointer_t<std::decay_t<Arg>>>, char>,
+            std::string,
+            std::decay_t<Arg>>;
+
+        struct Command {
+            const void* target{nullptr};
+            const void* key{nullptr};   //! nullptr for the functions
+            std::function<void()> apply;
+        };
+
+        struct Node {
+            std::atomic<Node*> next{nullptr};
+            Command command;
+        };
+
+        struct KeyHash {
+            std::size_t operator()(const std::pair<const void*, const void*>& key) const {
+                return std::hash<const void*>{}(key.first) ^ (std::hash<const void*>{}(key.second) << 1);
+            }
+        };
+
+        // One distinct address per setter
+        template<auto setter>
+        static constexpr char SETTER_KEY{};
+
+        // Last pushed node, written by the producers
+        std::atomic<Node*> head{&stub};
+        // Next node to pop, only used by the consumer
+        Node* tail{&stub};
+        Node stub;
+        // Reused between the drains
+        std::vector<Command> pending;
+        std::unordered_set<std::pair<const void*, const void*>, KeyHash> applied;
+
+        void push(Node* node);
+
+        Node* pop();
+    };
+
+}
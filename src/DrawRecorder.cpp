@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+module lysa.ui.draw_recorder;
+
+namespace lysa::ui {
+
+    void DrawRecorder::restart() {
+        previousStats = stats;
+        stats = {};
+        commands.clear();
+        texts.clear();
+        borders.clear();
+        batchTexture = INVALID_ID;
+        framesCount += 1;
+        if (forward) { forward->restart(); }
+    }
+
+    void DrawRecorder::setTranslate(const float2& translate) {
+        commands.push_back({.op = Op::TRANSLATE, .values = {translate.x, translate.y}});
+        stats.commands += 1;
+        stats.translateChanges += 1;
+        if (forward) { forward->setTranslate(translate); }
+    }
+
+    void DrawRecorder::setTransparency(const float alpha) {
+        commands.push_back({.op = Op::TRANSPARENCY, .values = {alpha}});
+        stats.commands += 1;
+        stats.transparencyChanges += 1;
+        if (forward) { forward->setTransparency(alpha); }
+    }
+
+    void DrawRecorder::setPenColor(const float4& color) {
+        commands.push_back({.op = Op::PEN_COLOR, .values = {color.r, color.g, color.b, color.a}});
+        stats.commands += 1;
+        stats.penColorChanges += 1;
+        if (forward) { forward->setPenColor(color); }
+    }
+
+    void DrawRecorder::drawLine(const float2& start, const float2& end) {
+        commands.push_back({.op = Op::LINE, .values = {start.x, start.y, end.x, end.y}});
+        stats.commands += 1;
+        stats.lines += 1;
+        countTexture(INVALID_ID);
+        if (forward) { forward->drawLine(start, end); }
+    }
+
+    void DrawRecorder::drawFilledRect(const float x, const float y, const float width, const float height, const unique_id texture) {
+        commands.push_back({.op = Op::FILLED_RECT, .texture = texture, .values = {x, y, width, height}});
+        stats.commands += 1;
+        if (texture == INVALID_ID) {
+            stats.filledRects += 1;
+        } else {
+            stats.texturedRects += 1;
+        }
+        countTexture(texture);
+        if (forward) { forward->drawFilledRect(x, y, width, height, texture); }
+    }
+
+    void DrawRecorder::drawTexturedRect(const float x, const float y, const float width, const float height,
+                                        const unique_id texture, const float4& uv) {
+        commands.push_back({
+            .op = Op::TEXTURED_RECT,
+            .texture = texture,
+            .values = {x, y, width, height},
+            .uv = {uv.x, uv.y, uv.z, uv.w}});
+        stats.commands += 1;
+        stats.texturedRects += 1;
+        countTexture(texture);
+        if (forward) { forward->drawTexturedRect(x, y, width, height, texture, uv); }
+    }
+
+    void DrawRecorder::drawNineSlice(const float x, const float y, const float width, const float height,
+                                     const unique_id texture, const float4& uv,
+                                     const float4& borders, const float4& uvBorders) {
+        commands.push_back({
+            .op = Op::NINE_SLICE,
+            .borders = static_cast<uint32>(this->borders.size()),
+            .texture = texture,
+            .values = {x, y, width, height},
+            .uv = {uv.x, uv.y, uv.z, uv.w}});
+        this->borders.push_back({borders, uvBorders});
+        stats.commands += 1;
+        stats.nineSlices += 1;
+        countTexture(texture);
+        if (forward) { forward->drawNineSlice(x, y, width, height, texture, uv, borders, uvBorders); }
+    }
+
+    void DrawRecorder::countTexture(const unique_id texture) {
+        if (texture != INVALID_ID && texture != batchTexture) {
+            stats.textureBatches += 1;
+        }
+        batchTexture = texture;
+    }
+
+    void DrawRecorder::drawText(const std::string& text, Font& font, const float fontScale, const float x, const float y) {
+        commands.push_back({.op = Op::TEXT, .text = static_cast<uint32>(texts.size()), .values = {fontScale, x, y}});
+        texts.push_back({text, &font});
+        stats.commands += 1;
+        stats.texts += 1;
+        stats.glyphs += static_cast<uint32>(text.size());
+        countTexture(INVALID_ID);
+        if (forward) { forward->drawText(text, font, fontScale, x, y); }
+    }
+
+    void DrawRecorder::replay(DrawSink& sink) const {
+        sink.restart();
+        for (const auto& command : commands) {
+            const auto* v = command.values;
+            switch (command.op) {
+            case Op::TRANSLATE:
+                sink.setTranslate({v[0], v[1]});
+                break;
+            case Op::TRANSPARENCY:
+                sink.setTransparency(v[0]);
+                break;
+            case Op::PEN_COLOR:
+                sink.setPenColor({v[0], v[1], v[2], v[3]});
+                break;
+            case Op::LINE:
+                sink.drawLine({v[0], v[1]}, {v[2], v[3]});
+                break;
+            case Op::FILLED_RECT:
+                sink.drawFilledRect(v[0], v[1], v[2], v[3], command.texture);
+                break;
+            case Op::TEXTURED_RECT: {
+                const auto* uv = command.uv;
+                sink.drawTexturedRect(v[0], v[1], v[2], v[3], command.texture, {uv[0], uv[1], uv[2], uv[3]});
+                break;
+            }
+            case Op::NINE_SLICE: {
+                const auto* uv = command.uv;
+                const auto& record = borders[command.borders];
+                sink.drawNineSlice(v[0], v[1], v[2], v[3], command.texture, {uv[0], uv[1], uv[2], uv[3]},
+                                   record.borders, record.uvBorders);
+                break;
+            }
+            case Op::TEXT: {
+                const auto& record = texts[command.text];
+                sink.drawText(record.text, *record.font, v[0], v[1], v[2]);
+                break;
+            }
+            }
+        }
+    }
+
+    std::string DrawRecorder::dump() const {
+        auto result = std::string{};
+        for (const auto& command : commands) {
+            const auto* v = command.values;
+            switch (command.op) {
+            case Op::TRANSLATE:
+                result += std::format("translate {} {}\n", v[0], v[1]);
+                break;
+            case Op::TRANSPARENCY:
+                result += std::format("transparency {}\n", v[0]);
+                break;
+            case Op::PEN_COLOR:
+                result += std::format("color {} {} {} {}\n", v[0], v[1], v[2], v[3]);
+                break;
+            case Op::LINE:
+                result += std::format("line {} {} {} {}\n", v[0], v[1], v[2], v[3]);
+                break;
+            case Op::FILLED_RECT:
+                if (command.texture == INVALID_ID) {
+                    result += std::format("rect {} {} {} {}\n", v[0], v[1], v[2], v[3]);
+                } else {
+                    result += std::format("rect {} {} {} {} texture {}\n", v[0], v[1], v[2], v[3], command.texture);
+                }
+                break;
+            case Op::TEXTURED_RECT:
+                result += std::format("rect {} {} {} {} texture {} uv {} {} {} {}\n", v[0], v[1], v[2], v[3], command.texture,
+                                      command.uv[0], command.uv[1], command.uv[2], command.uv[3]);
+                break;
+            case Op::NINE_SLICE: {
+                const auto& b = borders[command.borders].borders;
+                result += std::format("nine-slice {} {} {} {} texture {} uv {} {} {} {} borders {} {} {} {}\n",
+                                      v[0], v[1], v[2], v[3], command.texture,
+                                      command.uv[0], command.uv[1], command.uv[2], command.uv[3],
+                                      b.x, b.y, b.z, b.w);
+                break;
+            }
+            case Op::TEXT:
+                result += std::format("text {} {} {} \"{}\"\n", v[0], v[1], v[2], texts[command.text].text);
+                break;
+            }
+        }
+        return result;
+    }
+
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+export module lysa.ui.draw_recorder;
+
+import std;
+import lysa.math;
+import lysa.resources.font;
+import lysa.types;
+import lysa.ui.draw_sink;
+
+export namespace lysa::ui {
+
+    /**
+     * Draw sink recording the primitives of the current frame into a compact commands stream.
+     *
+     * The recorded frame can be inspected, compared with dump(), counted with getStats()
+     * and replayed into another sink. Recording works without any GPU when the recorder
+     * is not forwarding the primitives.
+     */
+    class DrawRecorder : public DrawSink {
+    public:
+        /**
+         * Recorded operations.
+         */
+        enum class Op : uint8 {
+            TRANSLATE,      //! values : x, y
+            TRANSPARENCY,   //! values : alpha
+            PEN_COLOR,      //! values : r, g, b, a
+            LINE,           //! values : start x, start y, end x, end y
+            FILLED_RECT,    //! values : x, y, width, height, plus texture
+            TEXTURED_RECT,  //! values : x, y, width, height, plus texture & uv
+            NINE_SLICE,     //! values : x, y, width, height, plus texture, uv & borders
+            TEXT,           //! values : scale, x, y, plus text
+        };
+
+        /**
+         * One recorded primitive.
+         */
+        struct Command {
+            Op op;
+            uint32 text{0};                 //! Index in getTexts() for TEXT
+            uint32 borders{0};              //! Index in getBorders() for NINE_SLICE
+            unique_id texture{INVALID_ID};  //! Texture for FILLED_RECT, TEXTURED_RECT & NINE_SLICE
+            float values[4]{};
+            float uv[4]{};                  //! Texture region for TEXTURED_RECT & NINE_SLICE
+        };
+
+        /**
+         * Borders of a NINE_SLICE command.
+         */
+        struct BordersRecord {
+            float4 borders;
+            float4 uvBorders;
+        };
+
+        /**
+         * Text of a TEXT command. The font must outlive the replay.
+         */
+        struct TextRecord {
+            std::string text;
+            Font* font;
+        };
+
+        /**
+         * Counters of a frame.
+         */
+        struct Stats {
+            uint32 commands{0};             //! Total number of commands
+            uint32 filledRects{0};          //! Untextured rectangles
+            uint32 texturedRects{0};        //! Textured rectangles, including the texture regions
+            uint32 nineSlices{0};           //! Nine-slice rectangles
+            uint32 textureBatches{0};       //! Runs of consecutive textured rectangles sharing a texture
+            uint32 lines{0};                //! Lines
+            uint32 texts{0};                //! Texts
+            uint32 glyphs{0};               //! Characters of all the texts
+            uint32 penColorChanges{0};      //! Pen color changes
+            uint32 translateChanges{0};     //! Translation changes
+            uint32 transparencyChanges{0};  //! Transparency changes
+        };
+
+        /**
+         * Creates a recorder.
+         * @param forward Optional sink receiving the primitives while recording.
+         */
+        explicit DrawRecorder(DrawSink* forward = nullptr): forward{forward} {}
+
+        /**
+         * Finishes the current frame and starts recording a new one.
+         */
+        void restart() override;
+
+        void setTranslate(const float2& translate) override;
+
+        void setTransparency(float alpha) override;
+
+        void setPenColor(const float4& color) override;
+
+        void drawLine(const float2& start, const float2& end) override;
+
+        void drawFilledRect(float x, float y, float width, float height, unique_id texture) override;
+
+        using DrawSink::drawFilledRect;
+
+        /**
+         * Returns the capability of the forwarding sink, or true when only recording.
+         */
+        bool supportsTextureRegions() const override { return forward ? forward->supportsTextureRegions() : true; }
+
+        void drawTexturedRect(float x, float y, float width, float height, unique_id texture, const float4& uv) override;
+
+        using DrawSink::drawTexturedRect;
+
+        void drawNineSlice(float x, float y, float width, float height, unique_id texture, const float4& uv,
+                           const float4& borders, const float4& uvBorders) override;
+
+        using DrawSink::drawNineSlice;
+
+        void drawText(const std::string& text, Font& font, float fontScale, float x, float y) override;
+
+        /**
+         * Sends the commands of the current frame to another sink, in the recorded order.
+         * @param sink The destination, usually a RendererDrawSink.
+         */
+        void replay(DrawSink& sink) const;
+
+        /**
+         * Returns a textual listing of the current frame, one command per line, to compare frames.
+         */
+        std::string dump() const;
+
+        /**
+         * Returns the commands of the current frame.
+         */
+        std::span<const Command> getCommands() const { return commands; }
+
+        /**
+         * Returns the texts of the current frame.
+         */
+        std::span<const TextRecord> getTexts() const { return texts; }
+
+        /**
+         * Returns the borders of the nine-slice commands of the current frame.
+         */
+        std::span<const BordersRecord> getBorders() const { return borders; }
+
+        /**
+         * Returns the counters of the current frame.
+         */
+        const Stats& getStats() const { return stats; }
+
+        /**
+         * Returns the counters of the previous frame.
+         */
+        const Stats& getPreviousStats() const { return previousStats; }
+
+        /**
+         * Returns the number of frames started since the creation.
+         */
+        auto getFramesCount() const { return framesCount; }
+
+    private:
+        DrawSink* forward;
+        // Vectors are cleared but keep their capacity between frames
+        std::vector<Command> commands;
+        std::vector<TextRecord> texts;
+        std::vector<BordersRecord> borders;
+        Stats stats;
+        Stats previousStats;
+        uint32 framesCount{0};
+        // Texture of the last primitive, to count the batches
+        unique_id batchTexture{INVALID_ID};
+
+        void countTexture(unique_id texture);
+    };
+
+}
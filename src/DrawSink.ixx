@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+export module lysa.ui.draw_sink;
+
+import std;
+import lysa.exception;
+import lysa.math;
+import lysa.rect;
+import lysa.renderers.vector_2d;
+import lysa.resources.font;
+import lysa.types;
+
+export namespace lysa::ui {
+
+    /**
+     * Destination of the UI drawing primitives.
+     *
+     * Styles draw through this interface, the WindowManager sends the primitives to
+     * its Vector2DRenderer by default, or to any other sink set with WindowManager::setDrawSink().
+     */
+    class DrawSink {
+    public:
+        virtual ~DrawSink() = default;
+
+        /**
+         * Starts a new frame.
+         */
+        virtual void restart() = 0;
+
+        /**
+         * Sets the translation applied to the following primitives.
+         */
+        virtual void setTranslate(const float2& translate) = 0;
+
+        /**
+         * Sets the transparency applied to the following primitives.
+         */
+        virtual void setTransparency(float alpha) = 0;
+
+        /**
+         * Sets the color of the following primitives.
+         */
+        virtual void setPenColor(const float4& color) = 0;
+
+        /**
+         * Draws a one pixel line.
+         */
+        virtual void drawLine(const float2& start, const float2& end) = 0;
+
+        /**
+         * Draws a filled rectangle, optionally textured.
+         * @param texture Image resource id, or INVALID_ID.
+         */
+        virtual void drawFilledRect(float x, float y, float width, float height, unique_id texture) = 0;
+
+        /**
+         * Draws a filled rectangle, optionally textured.
+         * @param texture Image resource id, or INVALID_ID.
+         */
+        void drawFilledRect(const Rect& rect, const unique_id texture = INVALID_ID) {
+            drawFilledRect(rect.x, rect.y, rect.width, rect.height, texture);
+        }
+
+        /**
+         * Returns true if the sink draws the texture regions of drawTexturedRect() & drawNineSlice().
+         * Callers must not use these primitives with sinks returning false.
+         */
+        virtual bool supportsTextureRegions() const { return false; }
+
+        /**
+         * Draws a rectangle textured with a region of a texture, like an atlas region.
+         * Only available if supportsTextureRegions() returns true.
+         * @param texture Image resource id.
+         * @param uv Region of the texture : left, top, right & bottom, between 0.0 and 1.0.
+         */
+        virtual void drawTexturedRect(const float x, const float y, const float width, const float height,
+                                      const unique_id texture, const float4& uv) {
+            assert([&]{ return supportsTextureRegions(); }, "DrawSink: texture regions not supported");
+            drawFilledRect(x, y, width, height, texture);
+        }
+
+        /**
+         * Draws a rectangle textured with a region of a texture, like an atlas region.
+         */
+        void drawTexturedRect(const Rect& rect, const unique_id texture, const float4& uv) {
+            drawTexturedRect(rect.x, rect.y, rect.width, rect.height, texture, uv);
+        }
+
+        /**
+         * Draws a rectangle textured with a nine-slice region : the corners keep their size,
+         * the edges are stretched along one axis and the center along both axes.
+         * The top border is drawn at `y + height`, like the other primitives.
+         * Only available if supportsTextureRegions() returns true, sinks that can't draw it
+         * as one primitive use up to nine textured rectangles.
+         * @param texture Image resource id.
+         * @param uv Region of the texture : left, top, right & bottom, between 0.0 and 1.0.
+         * @param borders Size of the left, top, right & bottom borders in the destination rectangle.
+         * @param uvBorders Size of the left, top, right & bottom borders in the texture, between 0.0 and 1.0.
+         */
+        virtual void drawNineSlice(const float x, const float y, const float width, const float height,
+                                   const unique_id texture, const float4& uv,
+                                   const float4& borders, const float4& uvBorders) {
+            // Borders larger than the rectangle are shrunk proportionally
+            const auto scaleX = borders.x + borders.z > width ? width / (borders.x + borders.z) : 1.0f;
+            const auto scaleY = borders.y + borders.w > height ? height / (borders.y + borders.w) : 1.0f;
+            const float xs[]{x, x + borders.x * scaleX, x + width - borders.z * scaleX, x + width};
+            const float ys[]{y + height, y + height - borders.y * scaleY, y + borders.w * scaleY, y};
+            const float us[]{uv.x, uv.x + uvBorders.x, uv.z - uvBorders.z, uv.z};
+            const float vs[]{uv.y, uv.y + uvBorders.y, uv.w - uvBorders.w, uv.w};
+            for (auto row = 0; row < 3; row++) {
+                const auto h = ys[row] - ys[row + 1];
+                if (h <= 0.0f) { continue; }
+                for (auto column = 0; column < 3; column++) {
+                    const auto w = xs[column + 1] - xs[column];
+                    if (w <= 0.0f) { continue; }
+                    drawTexturedRect(xs[column], ys[row + 1], w, h, texture,
+                                     float4{us[column], vs[row], us[column + 1], vs[row + 1]});
+                }
+            }
+        }
+
+        /**
+         * Draws a rectangle textured with a nine-slice region.
+         */
+        void drawNineSlice(const Rect& rect, const unique_id texture, const float4& uv,
+                           const float4& borders, const float4& uvBorders) {
+            drawNineSlice(rect.x, rect.y, rect.width, rect.height, texture, uv, borders, uvBorders);
+        }
+
+        /**
+         * Draws a single line of text.
+         */
+        virtual void drawText(const std::string& text, Font& font, float fontScale, float x, float y) = 0;
+    };
+
+    /**
+     * Draw sink sending the primitives to a Vector2DRenderer.
+     */
+    class RendererDrawSink : public DrawSink {
+    public:
+        explicit RendererDrawSink(Vector2DRenderer& renderer): renderer{renderer} {}
+
+        void restart() override { renderer.restart(); }
+
+        void setTranslate(const float2& translate) override { renderer.setTranslate(translate); }
+
+        void setTransparency(const float alpha) override { renderer.setTransparency(alpha); }
+
+        void setPenColor(const float4& color) override { renderer.setPenColor(color); }
+
+        void drawLine(const float2& start, const float2& end) override { renderer.drawLine(start, end); }
+
+        void drawFilledRect(const float x, const float y, const float width, const float height, const unique_id texture) override {
+            renderer.drawFilledRect(x, y, width, height, texture);
+        }
+
+        using DrawSink::drawFilledRect;
+
+        void drawText(const std::string& text, Font& font, const float fontScale, const float x, const float y) override {
+            renderer.drawText(text, font, fontScale, x, y);
+        }
+
+    private:
+        Vector2DRenderer& renderer;
+    };
+
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+export module lysa.ui.frame_stats;
+
+import std;
+import lysa.types;
+
+export namespace lysa::ui {
+
+    /**
+     * Timings & counters of one UI frame, see WindowManager::getFrameStats().
+     *
+     * A frame starts after the end of the previous WindowManager::drawFrame() and includes
+     * the input events dispatched before the drawing. Times are inclusive : the layout triggered
+     * by an input event is counted in both inputTime and layoutTime.
+     *
+     * The instrumentation is compiled only when LYSA_UI_FRAME_STATS is defined
+     * (CMake variable of the same name), otherwise all the values stay at zero.
+     */
+    struct FrameStats {
+#ifdef LYSA_UI_FRAME_STATS
+        static constexpr bool ENABLED{true};
+#else
+        static constexpr bool ENABLED{false};
+#endif
+        using Duration = std::chrono::nanoseconds;
+
+        Duration inputTime{};       //! Input events dispatch
+        Duration layoutTime{};      //! Widget::resizeChildren(), nested calls counted once
+        Duration drawTime{};        //! Styles drawing of all the windows
+        Duration windowsTime{};     //! Windows add, remove & visibility changes processing
+        uint32 inputEvents{0};      //! Input events received
+        uint32 layoutPasses{0};     //! Widget::resizeChildren() calls, nested calls included
+        uint32 widgetsLaidOut{0};   //! Children widgets placed by the layout passes
+        uint32 widgetsDrawn{0};     //! Visible widgets drawn
+        uint32 refreshes{0};        //! Redraw requests
+        uint32 eventsPushed{0};     //! UI events pushed to the engine events queue
+        uint32 allocations{0};      //! Widgets created & added to a window
+        uint32 windowsAdded{0};     //! Windows added to the manager
+        uint32 windowsRemoved{0};   //! Windows removed from the manager
+    };
+
+    /**
+     * Collects the FrameStats of a WindowManager.
+     *
+     * All the methods do nothing when FrameStats::ENABLED is false.
+     */
+    class FrameStatsCollector {
+    public:
+        /**
+         * Measures the time spent inside a C++ scope.
+         *
+         * A scope nested inside another scope measuring the same duration is ignored.
+         */
+        class Scope {
+        public:
+            /**
+             * Starts the measure.
+             * @param collector The collector, or nullptr to measure nothing.
+             * @param duration The FrameStats duration receiving the elapsed time.
+             */
+            Scope(FrameStatsCollector* collector, FrameStats::Duration FrameStats::* duration) {
+                if constexpr (FrameStats::ENABLED) {
+                    if (collector && collector->push(duration)) {
+                        this->collector = collector;
+                        this->duration = duration;
+                        start = std::chrono::steady_clock::now();
+                    }
+                }
+            }
+
+            ~Scope() {
+                if constexpr (FrameStats::ENABLED) {
+                    if (collector) {
+                        collector->stats.*duration += std::chrono::steady_clock::now() - start;
+                        collector->pop();
+                    }
+                }
+            }
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            FrameStatsCollector* collector{nullptr};
+            FrameStats::Duration FrameStats::* duration{nullptr};
+            std::chrono::steady_clock::time_point start;
+        };
+
+        /**
+         * Increments a counter of the current frame.
+         * @param counter The FrameStats counter.
+         * @param count The value to add.
+         */
+        void count(uint32 FrameStats::* counter, const uint32 count = 1) {
+            if constexpr (FrameStats::ENABLED) { stats.*counter += count; }
+        }
+
+        /**
+         * Ends the current frame and starts a new one.
+         */
+        void nextFrame() {
+            if constexpr (FrameStats::ENABLED) {
+                previousStats = stats;
+                stats = {};
+            }
+        }
+
+        /**
+         * Returns the timings & counters of the frame in progress.
+         */
+        const FrameStats& getStats() const { return stats; }
+
+        /**
+         * Returns the timings & counters of the last complete frame.
+         */
+        const FrameStats& getPreviousStats() const { return previousStats; }
+
+    private:
+        FrameStats stats;
+        FrameStats previousStats;
+        // Durations currently measured, to ignore the nested scopes
+        std::array<FrameStats::Duration FrameStats::*, 4> running{};
+        uint32 runningCount{0};
+
+        bool push(FrameStats::Duration FrameStats::* duration) {
+            const auto end = running.begin() + runningCount;
+            if (runningCount == running.size() || std::find(running.begin(), end, duration) != end) {
+                return false;
+            }
+            running[runningCount++] = duration;
+            return true;
+        }
+
+        void pop() { runningCount -= 1; }
+    };
+
+}
@@ -6,6 +6,7 @@
 */
 module lysa.ui.image;
 
+import lysa.exception;
 import lysa.ui.window;
 import lysa.ui.window_manager;
 
@@ -36,12 +37,16 @@ namespace lysa::ui {
     void Image::autoResize() {
         if (window) {
             const auto ratio = window->getWindowManager().getRenderer().getAspectRatio();
-            Widget::_setSize(std::round(image->getWidth() / ratio), static_cast<float>(image->getHeight()));
+            if (atlas) {
+                Widget::_setSize(std::round(region.width / ratio), region.height);
+            } else {
+                Widget::_setSize(std::round(image->getWidth() / ratio), static_cast<float>(image->getHeight()));
+            }
         }
     }
 
     void Image::eventCreate() {
-        if (image && autoSize) {
+        if ((image || atlas) && autoSize) {
             autoResize();
         }
         Widget::eventCreate();
@@ -57,7 +62,7 @@ namespace lysa::ui {
             return;
         }
         this->autoSize = autoSize;
-        if (autoSize && image) {
+        if (autoSize && (image || atlas)) {
             this->autoResize();
         }
     }
@@ -67,6 +72,7 @@ namespace lysa::ui {
             return;
         }
         this->image = &image;
+        atlas = nullptr;
         if (this->image) {
             if (autoSize) {
                 autoResize();
@@ -76,4 +82,21 @@ namespace lysa::ui {
         }
     }
 
+    void Image::setImage(const TextureAtlas& atlas, const unique_id source) {
+        const auto* sourceRegion = atlas.find(source);
+        if (!sourceRegion) { throw Exception("Can't find image ", std::to_string(source), " in the texture atlas"); }
+        if (this->atlas == &atlas && atlasSource == source) {
+            return;
+        }
+        this->atlas = &atlas;
+        region = *sourceRegion;
+        atlasSource = source;
+        image = nullptr;
+        if (autoSize) {
+            autoResize();
+        } else {
+            refresh();
+        }
+    }
+
 }
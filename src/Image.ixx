@@ -9,6 +9,8 @@ export module lysa.ui.image;
 import lysa.context;
 import lysa.math;
 import lysa.rect;
+import lysa.types;
+import lysa.ui.texture_atlas;
 import lysa.ui.widget;
 import lysa.resources.image;
 
@@ -54,6 +56,30 @@ export namespace lysa::ui {
          */
         void setImage(const lysa::Image& image);
 
+        /**
+         * Sets the image to display from a region of a texture atlas.
+         * The region is drawn with the page texture only by the draw sinks supporting texture regions,
+         * other sinks like the default RendererDrawSink draw the texture of the source image.
+         * @param atlas The atlas, must outlive the widget.
+         * @param source Id of the source image, already added to the atlas.
+         */
+        void setImage(const TextureAtlas& atlas, unique_id source);
+
+        /**
+         * Returns the atlas of the displayed image, or nullptr.
+         */
+        auto getAtlas() const { return atlas; }
+
+        /**
+         * Returns the atlas region of the displayed image, only meaningful if getAtlas() is not nullptr.
+         */
+        const auto& getRegion() const { return region; }
+
+        /**
+         * Returns the id of the source image of the atlas region, only meaningful if getAtlas() is not nullptr.
+         */
+        auto getAtlasSource() const { return atlasSource; }
+
         void _setSize(float width, float height) override;
 
         /**
@@ -66,6 +92,9 @@ export namespace lysa::ui {
         float4 color{1.0f};
         bool autoSize;
         const lysa::Image* image{nullptr};
+        const TextureAtlas* atlas{nullptr};
+        TextureAtlas::Region region{};
+        unique_id atlasSource{INVALID_ID};
 
         void autoResize();
 
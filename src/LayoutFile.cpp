@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+module lysa.ui.layout_file;
+
+import lysa.exception;
+
+namespace lysa::ui {
+
+    LayoutFile LayoutFile::parse(const std::string& text) {
+        auto layout = LayoutFile{};
+        // Indentation & index of the last node of each depth
+        auto parents = std::vector<std::pair<std::size_t, uint32>>{};
+
+        auto lineNumber = 0;
+        for (const auto& range : std::string_view{text} | std::views::split('\n')) {
+            auto line = std::string_view{range};
+            lineNumber += 1;
+            if (!line.empty() && line.back() == '\r') { line.remove_suffix(1); }
+            const auto indent = line.find_first_not_of(" \t");
+            if (indent == std::string_view::npos || line[indent] == '#') { continue; }
+
+            // Split the line into tokens, quoted strings can contain spaces and \" or \\ escapes
+            auto tokens = std::vector<std::string>{};
+            auto i = indent;
+            while (i < line.size()) {
+                if (line[i] == ' ' || line[i] == '\t') { i += 1; continue; }
+                auto token = std::string{};
+                while (i < line.size() && line[i] != ' ' && line[i] != '\t') {
+                    if (line[i] == '"') {
+                        i += 1;
+                        while (i < line.size() && line[i] != '"') {
+                            if (line[i] == '\\' && (i + 1) < line.size()) { i += 1; }
+                            token.push_back(line[i]);
+                            i += 1;
+                        }
+                        if (i == line.size()) {
+                            throw Exception("Unterminated string in layout line ", std::to_string(lineNumber));
+                        }
+                    } else {
+                        token.push_back(line[i]);
+                    }
+                    i += 1;
+                }
+                tokens.push_back(std::move(token));
+            }
+            if (tokens.size() < 2) {
+                throw Exception("Missing widget class or alignment in layout line ", std::to_string(lineNumber));
+            }
+
+            auto node = Node{};
+            const auto widgetClass = std::ranges::find(CLASS_NAMES, tokens[0]);
+            if (widgetClass == CLASS_NAMES.end()) {
+                throw Exception("Unknown widget class ", tokens[0], " in layout line ", std::to_string(lineNumber));
+            }
+            node.widgetClass = static_cast<uint32>(std::distance(CLASS_NAMES.begin(), widgetClass));
+            const auto alignment = std::ranges::find(ALIGNMENT_NAMES, tokens[1]);
+            if (alignment == ALIGNMENT_NAMES.end()) {
+                throw Exception("Unknown alignment ", tokens[1], " in layout line ", std::to_string(lineNumber));
+            }
+            node.alignment = static_cast<uint32>(std::distance(ALIGNMENT_NAMES.begin(), alignment));
+            for (auto t = std::size_t{2}; t < tokens.size(); t++) {
+                const auto& token = tokens[t];
+                const auto equal = token.find('=');
+                const auto name = std::string_view{token}.substr(0, equal);
+                const auto value = equal == std::string::npos ? std::string{} : token.substr(equal + 1);
+                if (name == "resource") {
+                    node.resource = layout.addString(value);
+                } else if (name == "text") {
+                    node.text = layout.addString(value);
+                } else if (name == "name") {
+                    node.name = layout.addString(value);
+                } else if (name == "padding") {
+                    try {
+                        node.padding = std::stof(value);
+                    } catch (const std::exception&) {
+                        throw Exception("Invalid padding in layout line ", std::to_string(lineNumber));
+                    }
+                } else if (name == "overlap") {
+                    node.flags |= OVERLAP;
+                } else {
+                    throw Exception("Unknown attribute ", std::string{name}, " in layout line ", std::to_string(lineNumber));
+                }
+            }
+
+            while (!parents.empty() && parents.back().first >= indent) {
+                parents.pop_back();
+            }
+            node.parent = parents.empty() ? NO_PARENT : parents.back().second;
+            parents.push_back({indent, layout.addNode(node)});
+        }
+        return layout;
+    }
+
+    LayoutFile LayoutFile::load(const std::string& path) {
+        auto input = std::ifstream(path, std::ios::binary);
+        if (!input) { throw Exception("Can't open layout file ", path); }
+        const auto data = std::vector<char>{std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+        try {
+            return deserialize(data);
+        } catch (const Exception&) {
+            throw Exception("Invalid layout file ", path);
+        }
+    }
+
+    LayoutFile LayoutFile::deserialize(const std::span<const char> data) {
+        auto header = Header{};
+        if (data.size() < sizeof(Header)) { throw Exception("Invalid binary layout"); }
+        std::memcpy(&header, data.data(), sizeof(Header));
+        const auto inside = [&](const std::uint64_t offset, const std::uint64_t length) {
+            return offset <= data.size() && length <= data.size() - offset;
+        };
+        if (header.magic != MAGIC || header.version != VERSION || header.size != data.size() ||
+            !inside(header.nodesOffset, std::uint64_t{header.nodesCount} * sizeof(Node)) ||
+            !inside(header.stringsOffset, header.stringsSize) ||
+            header.stringsSize == 0 ||
+            data[header.stringsOffset] != '\0' ||
+            data[header.stringsOffset + header.stringsSize - 1] != '\0') {
+            throw Exception("Invalid binary layout");
+        }
+
+        auto layout = LayoutFile{};
+        layout.nodes.resize(header.nodesCount);
+        std::memcpy(layout.nodes.data(), data.data() + header.nodesOffset, header.nodesCount * sizeof(Node));
+        layout.strings.assign(data.data() + header.stringsOffset, header.stringsSize);
+        for (auto index = uint32{0}; index < header.nodesCount; index++) {
+            const auto& node = layout.nodes[index];
+            if (node.widgetClass >= CLASS_COUNT ||
+                node.alignment >= ALIGNMENT_NAMES.size() ||
+                (node.parent != NO_PARENT && node.parent >= index) ||
+                node.resource >= header.stringsSize ||
+                node.text >= header.stringsSize ||
+                node.name >= header.stringsSize) {
+                throw Exception("Invalid binary layout");
+            }
+        }
+        return layout;
+    }
+
+    uint32 LayoutFile::addString(const std::string_view str) {
+        if (str.empty()) { return 0; }
+        const auto [it, inserted] = offsets.try_emplace(std::string{str}, static_cast<uint32>(strings.size()));
+        if (inserted) {
+            strings.append(str);
+            strings.push_back('\0');
+        }
+        return it->second;
+    }
+
+    uint32 LayoutFile::addNode(const Node& node) {
+        assert([&]{ return node.parent == NO_PARENT || node.parent < nodes.size(); }, "Layout node parent must be added first");
+        nodes.push_back(node);
+        return static_cast<uint32>(nodes.size() - 1);
+    }
+
+    std::vector<char> LayoutFile::serialize() const {
+        auto header = Header{
+            .magic = MAGIC,
+            .version = VERSION,
+            .nodesCount = static_cast<uint32>(nodes.size()),
+            .nodesOffset = sizeof(Header),
+            .stringsSize = static_cast<uint32>(strings.size()),
+        };
+        header.stringsOffset = header.nodesOffset + header.nodesCount * sizeof(Node);
+        header.size = header.stringsOffset + header.stringsSize;
+
+        auto result = std::vector<char>(header.size);
+        std::memcpy(result.data(), &header, sizeof(Header));
+        std::memcpy(result.data() + header.nodesOffset, nodes.data(), nodes.size() * sizeof(Node));
+        std::memcpy(result.data() + header.stringsOffset, strings.data(), strings.size());
+        return result;
+    }
+
+    void LayoutFile::save(const std::string& path) const {
+        const auto binary = serialize();
+        auto output = std::ofstream(path, std::ios::binary);
+        if (!output) { throw Exception("Can't create layout file ", path); }
+        output.write(binary.data(), static_cast<std::streamsize>(binary.size()));
+    }
+
+    void LayoutFile::convert(const std::string& textPath, const std::string& binaryPath) {
+        auto input = std::ifstream(textPath);
+        if (!input) { throw Exception("Can't open layout file ", textPath); }
+        parse(std::string{std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()}).save(binaryPath);
+    }
+
+    uint32 LayoutFile::indexOf(const std::string_view name) const {
+        for (auto index = uint32{0}; index < nodes.size(); index++) {
+            if (nodes[index].name != 0 && getString(nodes[index].name) == name) { return index; }
+        }
+        return NO_PARENT;
+    }
+
+}
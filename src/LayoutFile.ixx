@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+export module lysa.ui.layout_file;
+
+import std;
+import lysa.types;
+import lysa.ui.alignment;
+
+export namespace lysa::ui {
+
+    /**
+     * Declarative description of a widgets tree, instantiated in one pass by Window::createLayout().
+     *
+     * The text form describes one widget per line, children being indented below their parent :
+     * ```
+     * # Main menu
+     * Panel FILL resource=",,RAISED" padding=4
+     *     Text TOPCENTER text="Main menu" name=title
+     *     Button CENTER resource="200,40" name=play
+     *         Text CENTER text="Play"
+     * ```
+     * Each line starts with a widget class name and an Alignment name, followed by optional
+     * `resource="..."`, `text="..."`, `name=...`, `padding=...` and `overlap` attributes.
+     * Empty lines and lines starting with `#` are ignored.
+     *
+     * The binary form, produced by save() or convert(), is a Header followed by the nodes in
+     * depth-first order and a block of null-terminated strings. It's loaded without any parsing.
+     */
+    class LayoutFile {
+    public:
+        /**
+         * Widget classes that can be instantiated from a layout.
+         */
+        enum Class : uint32 {
+            WIDGET,         //! `Widget`
+            PANEL,          //! `Panel`
+            BOX,            //! `Box`
+            HLINE,          //! `HLine`
+            VLINE,          //! `VLine`
+            FRAME,          //! `Frame`, `text` is the title
+            BUTTON,         //! `Button`
+            TOGGLEBUTTON,   //! `ToggleButton`
+            TEXT,           //! `Text`
+            TEXTEDIT,       //! `TextEdit`
+            VSCROLLBAR,     //! `VScrollBar`
+            HSCROLLBAR,     //! `HScrollBar`
+            TREEVIEW,       //! `TreeView`
+            IMAGE,          //! `Image`
+            CLASS_COUNT
+        };
+
+        /**
+         * Node flags.
+         */
+        enum Flags : uint32 {
+            OVERLAP = 0b0001, //! Overlap widget on top of other widgets
+        };
+
+        /**
+         * File header.
+         */
+        struct Header {
+            uint32 magic;          //! MAGIC
+            uint32 version;        //! VERSION
+            uint32 size;           //! Total size of the file
+            uint32 nodesCount;     //! Number of Node
+            uint32 nodesOffset;    //! Offset of the first Node
+            uint32 stringsOffset;  //! Offset of the strings block
+            uint32 stringsSize;    //! Size of the strings block
+        };
+
+        /**
+         * One widget of the tree.
+         */
+        struct Node {
+            uint32 widgetClass;  //! Class of the widget
+            uint32 alignment;    //! Alignment in the parent widget
+            uint32 parent;       //! Index of the parent node, or NO_PARENT for the Window main widget
+            uint32 flags;        //! Flags
+            float padding;       //! Children padding
+            uint32 resource;     //! Resources description string
+            uint32 text;         //! Text or title
+            uint32 name;         //! Name used by indexOf()
+        };
+
+        static constexpr uint32 MAGIC{0x4c49554c}; //! "LUIL"
+        static constexpr uint32 VERSION{1};
+        static constexpr uint32 NO_PARENT{0xffffffff};
+
+        /**
+         * Names of the widget classes in the text form.
+         */
+        static constexpr std::array<std::string_view, CLASS_COUNT> CLASS_NAMES{
+            "Widget", "Panel", "Box", "HLine", "VLine", "Frame", "Button", "ToggleButton",
+            "Text", "TextEdit", "VScrollBar", "HScrollBar", "TreeView", "Image",
+        };
+
+        /**
+         * Names of the alignments in the text form, in Alignment order.
+         */
+        static constexpr std::array<std::string_view, 25> ALIGNMENT_NAMES{
+            "NONE", "FILL", "CENTER", "HCENTER", "VCENTER", "TOP", "BOTTOM", "LEFT", "RIGHT",
+            "TOPCENTER", "BOTTOMCENTER", "LEFTCENTER", "RIGHTCENTER", "TOPLEFT", "BOTTOMLEFT",
+            "BOTTOMRIGHT", "TOPRIGHT", "LEFTTOP", "LEFTBOTTOM", "RIGHTBOTTOM", "RIGHTTOP",
+            "CORNERTOPLEFT", "CORNERTOPRIGHT", "CORNERBOTTOMLEFT", "CORNERBOTTOMRIGHT",
+        };
+
+        /**
+         * Creates an empty layout, filled with addNode().
+         */
+        LayoutFile() = default;
+
+        /**
+         * Compiles a layout from its text form.
+         * @param text Content of the text layout.
+         */
+        static LayoutFile parse(const std::string& text);
+
+        /**
+         * Loads a binary layout file.
+         * @param path Path of the binary layout file.
+         */
+        static LayoutFile load(const std::string& path);
+
+        /**
+         * Reads the binary form of a layout.
+         * @param data Content of a binary layout, as returned by serialize().
+         */
+        static LayoutFile deserialize(std::span<const char> data);
+
+        /**
+         * Converts a text layout file into a binary layout file.
+         * @param textPath Path of the text layout file to read.
+         * @param binaryPath Path of the binary layout file to write.
+         */
+        static void convert(const std::string& textPath, const std::string& binaryPath);
+
+        /**
+         * Returns the binary form of the layout.
+         */
+        std::vector<char> serialize() const;
+
+        /**
+         * Writes the binary form of the layout.
+         * @param path Path of the binary layout file.
+         */
+        void save(const std::string& path) const;
+
+        /**
+         * Adds a string to the strings block.
+         * @return The string offset, identical strings share the same offset.
+         */
+        uint32 addString(std::string_view str);
+
+        /**
+         * Adds a node, its parent must have been added before.
+         * @return The index of the node.
+         */
+        uint32 addNode(const Node& node);
+
+        /**
+         * Returns the nodes, parents always come before their children.
+         */
+        std::span<const Node> getNodes() const { return nodes; }
+
+        /**
+         * Returns the alignment of a node.
+         */
+        static Alignment getAlignment(const Node& node) { return static_cast<Alignment>(node.alignment); }
+
+        /**
+         * Returns the index of a named node, or NO_PARENT if not found.
+         */
+        uint32 indexOf(std::string_view name) const;
+
+        /**
+         * Returns a string of the strings block.
+         */
+        std::string_view getString(const uint32 offset) const { return {strings.data() + offset}; }
+
+    private:
+        std::vector<Node> nodes;
+        // Null-terminated strings, the offset 0 is the empty string
+        std::string strings{std::string(1, '\0')};
+        // Offsets of the strings added with addString()
+        std::unordered_map<std::string, uint32> offsets;
+    };
+
+}
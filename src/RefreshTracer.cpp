@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+module lysa.ui.refresh_tracer;
+
+namespace lysa::ui {
+
+    void RefreshTracer::refresh(const unique_id source, const std::source_location& location) {
+        records.push_back({source, location});
+        auto& counter = counters[source];
+        counter.refreshes += 1;
+        maxCounters.refreshes = std::max(maxCounters.refreshes, counter.refreshes);
+    }
+
+    void RefreshTracer::layout(const unique_id source) {
+        auto& counter = counters[source];
+        counter.layouts += 1;
+        maxCounters.layouts = std::max(maxCounters.layouts, counter.layouts);
+    }
+
+    void RefreshTracer::nextFrame() {
+        // Swap to keep the capacity of both vectors between frames
+        std::swap(records, previousRecords);
+        records.clear();
+    }
+
+    void RefreshTracer::reset() {
+        records.clear();
+        previousRecords.clear();
+        counters.clear();
+        maxCounters = {};
+    }
+
+    RefreshTracer::Counters RefreshTracer::getCounters(const unique_id source) const {
+        const auto it = counters.find(source);
+        return it == counters.end() ? Counters{} : it->second;
+    }
+
+    float4 RefreshTracer::getHeatColor(const unique_id source) const {
+        const auto counter = getCounters(source);
+        const auto refreshHeat = maxCounters.refreshes == 0 ? 0.0f :
+            static_cast<float>(counter.refreshes) / static_cast<float>(maxCounters.refreshes);
+        const auto layoutHeat = maxCounters.layouts == 0 ? 0.0f :
+            static_cast<float>(counter.layouts) / static_cast<float>(maxCounters.layouts);
+        const auto heat = std::max(refreshHeat, layoutHeat);
+        return {refreshHeat, layoutHeat, 0.0f, heat == 0.0f ? 0.0f : 0.15f + 0.45f * heat};
+    }
+
+    std::string RefreshTracer::dump() const {
+        auto result = std::string{};
+        for (const auto& record : previousRecords) {
+            result += std::format("{} {}:{} {}\n",
+                record.source,
+                record.location.file_name(),
+                record.location.line(),
+                record.location.function_name());
+        }
+        return result;
+    }
+
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+export module lysa.ui.refresh_tracer;
+
+import std;
+import lysa.math;
+import lysa.types;
+
+export namespace lysa::ui {
+
+    /**
+     * Records who requested the UI redraws, see WindowManager::setRefreshTracing().
+     *
+     * For each frame the tracer keeps the widget (or Window) and the call site of every
+     * refresh request, and for each widget the cumulative number of refreshes and layout passes.
+     */
+    class RefreshTracer {
+    public:
+        /**
+         * One refresh request.
+         */
+        struct Record {
+            unique_id source;               //! Widget or Window id, INVALID_ID for the WindowManager
+            std::source_location location;  //! Call site of the refresh
+        };
+
+        /**
+         * Cumulative counters of a widget.
+         */
+        struct Counters {
+            uint32 refreshes{0};  //! Refresh requests
+            uint32 layouts{0};    //! Layout passes of the children
+        };
+
+        /**
+         * Returns true if the requests are recorded.
+         */
+        auto isEnabled() const { return enabled; }
+
+        /**
+         * Starts or stops the recording.
+         */
+        void setEnabled(const bool enable) { enabled = enable; }
+
+        /**
+         * Records a refresh request.
+         */
+        void refresh(unique_id source, const std::source_location& location);
+
+        /**
+         * Records a layout pass.
+         */
+        void layout(unique_id source);
+
+        /**
+         * Ends the current frame and starts a new one.
+         */
+        void nextFrame();
+
+        /**
+         * Clears the records & all the counters.
+         */
+        void reset();
+
+        /**
+         * Returns the refresh requests of the last complete frame.
+         */
+        std::span<const Record> getRecords() const { return previousRecords; }
+
+        /**
+         * Returns the cumulative counters of a widget.
+         */
+        Counters getCounters(unique_id source) const;
+
+        /**
+         * Returns the heatmap tint of a widget : red for the refreshes, green for the layouts,
+         * scaled by the highest counters, fully transparent for widgets never recorded.
+         */
+        float4 getHeatColor(unique_id source) const;
+
+        /**
+         * Returns a textual listing of the last complete frame, one request per line.
+         */
+        std::string dump() const;
+
+    private:
+        bool enabled{false};
+        std::vector<Record> records;
+        std::vector<Record> previousRecords;
+        std::unordered_map<unique_id, Counters> counters;
+        Counters maxCounters;
+    };
+
+}
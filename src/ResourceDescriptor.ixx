@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+export module lysa.ui.resource_descriptor;
+
+import std;
+import lysa.exception;
+import lysa.types;
+
+export namespace lysa::ui {
+
+    /**
+     * Typed description of a widget resources string.
+     *
+     * The description string format is `width,height,style,r,g,b,a` where every part is optional
+     * and style is one of `FLAT`, `RAISED` or `LOWERED`. The color, if present, must have four components.
+     */
+    struct ResourceDescriptor {
+        /**
+         * Requested appearance.
+         */
+        enum Style : uint8 {
+            DEFAULT, //! Style default appearance
+            FLAT,    //! Flat appearance
+            RAISED,  //! 3D raised appearance
+            LOWERED  //! 3D lowered appearance
+        };
+
+        std::string_view source{};        //! The description string
+        float width{0};                   //! Requested width
+        float height{0};                  //! Requested height
+        Style style{DEFAULT};             //! Requested appearance
+        bool customColor{false};          //! Whether a custom color is used
+        std::array<float, 4> color{};     //! Custom color value
+
+        /**
+         * Parses a resources description string.
+         *
+         * Usable at compile time, where a malformed string is a compilation error,
+         * or at runtime, where a malformed string throws an Exception.
+         * @param resource The description string, must outlive the descriptor.
+         */
+        static constexpr ResourceDescriptor parse(const std::string_view resource) {
+            auto desc = ResourceDescriptor{.source = resource};
+            auto index = 0;
+            auto start = std::size_t{0};
+            while (start <= resource.size()) {
+                auto end = resource.find(',', start);
+                if (end == std::string_view::npos) { end = resource.size(); }
+                const auto token = resource.substr(start, end - start);
+                switch (index) {
+                case 0:
+                    if (!token.empty()) { desc.width = parseNumber(token); }
+                    break;
+                case 1:
+                    if (!token.empty()) { desc.height = parseNumber(token); }
+                    break;
+                case 2:
+                    desc.style = parseStyle(token);
+                    break;
+                case 3: case 4: case 5: case 6:
+                    desc.color[index - 3] = parseNumber(token);
+                    desc.customColor = true;
+                    break;
+                default:
+                    throw Exception("Too many values in resource ", std::string{resource});
+                }
+                index += 1;
+                start = end + 1;
+            }
+            if (desc.customColor && (index != 7)) {
+                throw Exception("Resource color needs four components in ", std::string{resource});
+            }
+            return desc;
+        }
+
+    private:
+        static constexpr Style parseStyle(const std::string_view token) {
+            if (token.empty()) { return DEFAULT; }
+            if (token == "FLAT") { return FLAT; }
+            if (token == "RAISED") { return RAISED; }
+            if (token == "LOWERED") { return LOWERED; }
+            throw Exception("Unknown resource style ", std::string{token});
+        }
+
+        static constexpr bool isDigit(const char c) { return c >= '0' && c <= '9'; }
+
+        static constexpr float parseNumber(std::string_view token) {
+            while (!token.empty() && token.front() == ' ') { token.remove_prefix(1); }
+            while (!token.empty() && token.back() == ' ') { token.remove_suffix(1); }
+            auto i = std::size_t{0};
+            auto negative = false;
+            if (i < token.size() && (token[i] == '-' || token[i] == '+')) {
+                negative = token[i] == '-';
+                i += 1;
+            }
+            auto value = 0.0;
+            auto digits = 0;
+            while (i < token.size() && isDigit(token[i])) {
+                value = value * 10.0 + (token[i] - '0');
+                digits += 1;
+                i += 1;
+            }
+            if (i < token.size() && token[i] == '.') {
+                i += 1;
+                auto scale = 0.1;
+                while (i < token.size() && isDigit(token[i])) {
+                    value += (token[i] - '0') * scale;
+                    scale /= 10.0;
+                    digits += 1;
+                    i += 1;
+                }
+            }
+            if (digits == 0) {
+                throw Exception("Invalid number in resource : ", std::string{token});
+            }
+            if (i < token.size() && (token[i] == 'e' || token[i] == 'E')) {
+                i += 1;
+                auto negativeExponent = false;
+                if (i < token.size() && (token[i] == '-' || token[i] == '+')) {
+                    negativeExponent = token[i] == '-';
+                    i += 1;
+                }
+                auto exponent = 0;
+                auto exponentDigits = 0;
+                while (i < token.size() && isDigit(token[i])) {
+                    exponent = exponent * 10 + (token[i] - '0');
+                    exponentDigits += 1;
+                    i += 1;
+                }
+                if (exponentDigits == 0) {
+                    throw Exception("Invalid number in resource : ", std::string{token});
+                }
+                for (auto e = 0; e < exponent; e++) {
+                    value = negativeExponent ? value / 10.0 : value * 10.0;
+                }
+            }
+            if (i != token.size()) {
+                throw Exception("Invalid number in resource : ", std::string{token});
+            }
+            return static_cast<float>(negative ? -value : value);
+        }
+    };
+
+    /**
+     * Resources description string usable as a template argument.
+     */
+    template<std::size_t N>
+    struct ResourceString {
+        char value[N]{};
+
+        consteval ResourceString(const char (&str)[N]) {
+            std::copy_n(str, N, value);
+        }
+
+        constexpr std::string_view view() const { return {value, N - 1}; }
+    };
+
+    /**
+     * Resources description parsed at compile time.
+     *
+     * Usage : `panel->create<Button>(res<"100,40,RAISED">, Alignment::CENTER)`.
+     * A malformed description string is a compilation error.
+     */
+    template<ResourceString S>
+    inline constexpr ResourceDescriptor res = ResourceDescriptor::parse(S.view());
+
+}
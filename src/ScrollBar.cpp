@@ -8,6 +8,9 @@ module lysa.ui.scroll_bar;
 
 import lysa.log;
 import lysa.ui.alignment;
+import lysa.ui.tweens;
+import lysa.ui.window;
+import lysa.ui.window_manager;
 
 namespace lysa::ui {
 
@@ -40,10 +43,46 @@ namespace lysa::ui {
     }
 
     bool ScrollBar::eventMouseUp(const MouseButton button, const float x, const float y) {
-        onScroll = false;
+        if (onScroll) {
+            onScroll = false;
+            liftCage->setPushed(false);
+            // Glides only if the lift was still moving when released
+            const auto released = std::chrono::steady_clock::now() - dragTime;
+            if (smoothScrolling &&
+                (released < std::chrono::milliseconds{100}) &&
+                (std::abs(dragSpeed) >= (INERTIA_MIN_SPEED * step))) {
+                // A cubic ease out starts at three times its average speed
+                animateTo(std::clamp(value + dragSpeed * INERTIA_DURATION / 3.0f, min, max), INERTIA_DURATION);
+            }
+        }
         return ValueSelect::eventMouseUp(button, x, y);
     }
 
+    void ScrollBar::scroll(const float steps) {
+        const auto from = scrollAnimated ? scrollTarget : value;
+        const auto target = std::clamp(from + steps * step, min, max);
+        if (smoothScrolling) {
+            animateTo(target, SMOOTH_DURATION);
+        } else {
+            setValue(target);
+        }
+    }
+
+    void ScrollBar::animateTo(const float target, const float duration) {
+        if (window == nullptr) {
+            setValue(target);
+            return;
+        }
+        scrollTarget = target;
+        scrollAnimated = true;
+        window->getWindowManager().getTweens().value(
+            std::static_pointer_cast<ValueSelect>(shared_from_this()),
+            target,
+            duration,
+            Easing::CUBIC_OUT,
+            [this] { scrollAnimated = false; });
+    }
+
     bool ScrollBar::eventMouseMove(const uint32 button, const float x, const float y) {
         if (onScroll) {
             if (getRect().contains(x, y)) {
@@ -65,6 +104,13 @@ namespace lysa::ui {
                     }
                     const float prev = value;
                     value = std::min(std::max(newval, min), max);
+                    const auto now = std::chrono::steady_clock::now();
+                    const auto elapsed = std::chrono::duration<float>(now - dragTime).count();
+                    if (elapsed > 0.0f) {
+                        // Smoothed, the mouse events are irregular
+                        dragSpeed = 0.5f * dragSpeed + 0.5f * (value - prev) / elapsed;
+                        dragTime = now;
+                    }
                     eventValueChange(prev);
                 }
                 return true;
@@ -81,16 +127,18 @@ namespace lysa::ui {
         liftCage->setPushed(onScroll);
         const Rect& rect = liftArea->getRect();
         if (rect.width && rect.height && ((max - min) > 0.0f)) {
-            liftRefresh(rect);
+            liftResize(rect);
+            liftMove(rect);
             ValueSelect::eventRangeChange();
         }
     }
 
     void ScrollBar::eventValueChange(const float prev) {
+        if (liftArea == nullptr) { return; }
         liftCage->setPushed(onScroll);
         const Rect& rect = liftArea->getRect();
         if (rect.width && rect.height && ((max - min) > 0.0f)) {
-            liftRefresh(rect);
+            liftMove(rect);
             ValueSelect::eventValueChange(prev);
         }
     }
@@ -122,7 +170,13 @@ namespace lysa::ui {
     }
 
     void ScrollBar::onLiftCageDown(const UIEventMouseButton& event) {
+        if (scrollAnimated) {
+            window->getWindowManager().getTweens().cancel(*this);
+            scrollAnimated = false;
+        }
         onScroll = true;
+        dragSpeed = 0;
+        dragTime = std::chrono::steady_clock::now();
         if (type == VERTICAL) {
             scrollStart = event.y - liftCage->getRect().y;
         }
@@ -131,37 +185,35 @@ namespace lysa::ui {
         }
     }
 
-    void ScrollBar::liftRefresh(const Rect& rect) const {
+    void ScrollBar::liftResize(const Rect& rect) const {
+        const auto size = type == VERTICAL ? rect.height : rect.width;
+        const auto nbvalues = max - min;
+        const auto liftSize = size >= nbvalues ? size - nbvalues : static_cast<float>(LIFT_MINWIDTH);
+        const auto width = type == VERTICAL ? rect.width : liftSize;
+        const auto height = type == VERTICAL ? liftSize : rect.height;
+        if ((width == liftCage->getWidth()) && (height == liftCage->getHeight())) { return; }
+        // Also the default size, kept by the relayouts of the scroll bar
+        liftCage->setSize(width, height);
+    }
+
+    void ScrollBar::liftMove(const Rect& rect) const {
         float size;
+        float liftSize;
         if (type == VERTICAL) {
             size = rect.height;
-        }
-        else {
-            size = rect.width;
-        }
-        float liftSize = LIFT_MINWIDTH;
-        const float nbvalues = max - min;
-        if (size >= nbvalues) {
-            liftSize = size - nbvalues;
-        }
-        if (type == VERTICAL) {
-            liftCage->_setSize(rect.width, liftSize);
             liftSize = liftCage->getHeight();
         }
         else {
-            liftCage->_setSize(liftSize, rect.height);
+            size = rect.width;
             liftSize = liftCage->getWidth();
         }
-        const auto liftPos = ((value - min) * (size - liftSize)) / nbvalues;
+        const auto liftPos = ((value - min) * (size - liftSize)) / (max - min);
         if (type == VERTICAL) {
-            //log(to_std::string(liftPos), to_std::string(liftSize), to_std::string(size));
             liftCage->setPos(rect.x, rect.y + size - liftSize - liftPos);
         }
         else {
             liftCage->setPos(rect.x + liftPos, rect.y);
         }
-        liftArea->refresh();
-        liftCage->refresh();
     }
 
 }
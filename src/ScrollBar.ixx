@@ -6,6 +6,7 @@
 */
 export module lysa.ui.scroll_bar;
 
+import std;
 import lysa.context;
 import lysa.input_event;
 import lysa.rect;
@@ -23,6 +24,9 @@ export namespace lysa::ui {
     public:
         static constexpr auto LIFT_MINWIDTH{10}; //! Minimum width of the scroll lift
         static constexpr auto LONGSTEP_MUX{5};   //! Multiplier for long step (page) scroll
+        static constexpr auto SMOOTH_DURATION{0.15f}; //! Duration in seconds of a smooth scroll
+        static constexpr auto INERTIA_DURATION{0.6f}; //! Duration in seconds of the glide after a kinetic drag
+        static constexpr auto INERTIA_MIN_SPEED{2.0f}; //! Minimum drag speed, in steps per second, for a glide
 
         /**
          * Scroll bar orientation.
@@ -61,10 +65,41 @@ export namespace lysa::ui {
          */
         void setResources(const std::string& area, const std::string& cage);
 
+        /**
+         * Returns the scroll lift, nullptr before setResources().
+         */
+        const Box* getLift() const { return liftCage.get(); }
+
+        /**
+         * Scrolls by a number of steps, for the mouse wheel.
+         * The wheel events are not received by the widgets, the application forwards them here.
+         * When the smooth scrolling is enabled the value is animated over the next frames,
+         * successive calls during the animation add up.
+         * @param steps Number of steps, negative to scroll toward the minimum.
+         */
+        void scroll(float steps);
+
+        /**
+         * Enables or disables the smooth scrolling & the glide after releasing the lift. Enabled by default.
+         */
+        void setSmoothScrolling(const bool smooth) { smoothScrolling = smooth; }
+
+        /**
+         * Returns true if the smooth scrolling is enabled.
+         */
+        bool isSmoothScrolling() const { return smoothScrolling; }
+
     private:
         Type type;
         bool onScroll{false};
         float scrollStart{0};
+        bool smoothScrolling{true};
+        // Target value of the running smooth scroll
+        float scrollTarget{0};
+        bool scrollAnimated{false};
+        // Drag speed in values per second, for the glide when the lift is released
+        float dragSpeed{0};
+        std::chrono::steady_clock::time_point dragTime;
         std::shared_ptr<Box> liftArea;
         std::shared_ptr<Box> liftCage;
 
@@ -80,7 +115,13 @@ export namespace lysa::ui {
 
         void onLiftCageDown(const UIEventMouseButton& event);
 
-        void liftRefresh(const Rect& rect) const;
+        // Changes the lift size, only when the range or the size of the scroll bar changed
+        void liftResize(const Rect& rect) const;
+
+        // Moves the lift to the current value without any layout
+        void liftMove(const Rect& rect) const;
+
+        void animateTo(float target, float duration);
     };
 
     /**
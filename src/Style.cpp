@@ -9,52 +9,137 @@ module lysa.ui.style;
 import lysa.exception;
 import lysa.types;
 import lysa.ui.style_classic;
+import lysa.ui.style_pixmap;
 
 namespace lysa::ui {
 
     Style::Style() { font = nullptr; }
 
-    std::shared_ptr<Style> Style::create(const std::string &name) {
+    Style::ThemeSnapshot::ThemeSnapshot(const Options& options, const std::shared_ptr<const ThemeFile>& file):
+        file{file},
+        options{options} {
+    }
+
+    std::string Style::ThemeSnapshot::getOption(const std::string& name) const {
+        if (const auto it = options.find(name); it != options.end()) {
+            return it->second;
+        }
+        if (!file) { return ""; }
+        // Values of the binary theme are only formatted when requested, in the options format
+        for (auto slot = 0u; slot < ThemeFile::COLOR_COUNT; slot++) {
+            const auto color = static_cast<ThemeFile::Color>(slot);
+            if (name == ThemeFile::COLOR_NAMES[slot]) {
+                if (!file->hasColor(color)) { return ""; }
+                const auto c = file->getColor(color);
+                return std::format("{},{},{},{}", c.r, c.g, c.b, c.a);
+            }
+        }
+        for (auto slot = 0u; slot < ThemeFile::METRIC_COUNT; slot++) {
+            const auto metric = static_cast<ThemeFile::Metric>(slot);
+            if (name == ThemeFile::METRIC_NAMES[slot]) {
+                return file->hasMetric(metric) ? std::format("{}", file->getMetric(metric)) : "";
+            }
+        }
+        if (name == "skin") {
+            return std::string{file->getSkin()};
+        }
+        if (name.starts_with("nine_slice.")) {
+            if (const auto* slice = file->findNineSlice(std::string_view{name}.substr(11))) {
+                return std::format("{},{},{},{},{},{},{},{}",
+                                   slice->x, slice->y, slice->width, slice->height,
+                                   slice->left, slice->top, slice->right, slice->bottom);
+            }
+        }
+        return "";
+    }
+
+    std::shared_ptr<Style> Style::create(const std::string &name, const std::shared_ptr<const ThemeFile>& theme) {
         std::shared_ptr<Style> style;
         if (name == "vector") {
             style = std::make_shared<StyleClassic>();
+        } else if (name == "pixmap") {
+            style = std::make_shared<StylePixmap>();
         }
-        /*else if (NAME == "pixmap") {
-            tmp = (GLayout*) new GLayoutPixmap;
-        }*/
         if (!style) { throw Exception("No style named ", name); }
         style->init();
-        style->updateOptions();
+        style->setTheme(style->compileTheme({}, theme));
         return style;
     }
 
-    void Style::setOption(const std::string &name, const std::string &value) {
-        std::shared_ptr<StyleOption> option;
-        for (const auto &opt : options) {
-            if (opt->name == name) {
-                option = opt;
-                break;
-            }
+    void Style::registerType(const Widget::Type type, const TypeHooks& typeHooks) {
+        auto& entry = hooks[type];
+        if (typeHooks.drawBefore) { entry.drawBefore = typeHooks.drawBefore; }
+        if (typeHooks.drawAfter) { entry.drawAfter = typeHooks.drawAfter; }
+        if (typeHooks.resize) { entry.resize = typeHooks.resize; }
+        if (typeHooks.resource) { entry.resource = typeHooks.resource; }
+    }
+
+    const Style::TypeHooks& Style::getHooks(const Widget::Type type) {
+        return hooks[type];
+    }
+
+    void Style::draw(const Widget &widget, const UIResource &resources, DrawSink &render, const bool when) {
+        const auto& typeHooks = getHooks(widget.getType());
+        const auto function = when ? typeHooks.drawBefore : typeHooks.drawAfter;
+        if (function) { function(*this, widget, resources, render); }
+    }
+
+    void Style::resize(Widget &widget, Rect &rect, const UIResource &resources) {
+        const auto& typeHooks = getHooks(widget.getType());
+        if (typeHooks.resize) { typeHooks.resize(*this, widget, rect, resources); }
+    }
+
+    void Style::addResource(Widget &widget, const std::string &resources) {
+        applyResource(widget, getResource(resources));
+    }
+
+    void Style::addResource(Widget &widget, const ResourceDescriptor &resources) {
+        applyResource(widget, getResource(resources));
+    }
+
+    void Style::addResource(Widget &widget, const std::shared_ptr<const UIResource> &resource) {
+        applyResource(widget, resource);
+    }
+
+    std::shared_ptr<const UIResource> Style::getResource(const std::string &res) {
+        if (const auto it = internedResources.find(res); it != internedResources.end()) {
+            return it->second;
         }
-        if (option == nullptr) {
-            option = make_shared<StyleOption>(name);
-            options.push_back(option);
+        return getResource(ResourceDescriptor::parse(res));
+    }
+
+    std::shared_ptr<const UIResource> Style::getResource(const ResourceDescriptor &res) {
+        if (const auto it = internedResources.find(res.source); it != internedResources.end()) {
+            return it->second;
         }
-        option->value = value;
-        updateOptions();
+        auto resource = createResource(res);
+        internedResources.emplace(resource->getResource(), resource);
+        return resource;
+    }
+
+    void Style::setOption(const std::string &name, const std::string &value) {
+        applyTheme({{name, value}});
     }
 
     std::string Style::getOption(const std::string &name) const {
-        std::shared_ptr<StyleOption> option;
-        for (const auto &opt : options) {
-            if (opt->name == name) {
-                option = opt;
-                break;
-            }
-        }
-        if (option == nullptr) {
-            return "";
+        return theme->getOption(name);
+    }
+
+    void Style::applyTheme(const Options &options) {
+        // Only the overrides are merged, the binary theme values are used in place by the new snapshot
+        auto merged = theme->getOptions();
+        for (const auto& [name, value] : options) {
+            merged[name] = value;
         }
-        return option->value;
+        setTheme(compileTheme(merged, theme->getFile()));
+    }
+
+    void Style::loadTheme(const std::string &path) {
+        setTheme(compileTheme({}, ThemeFile::load(path)));
+    }
+
+    void Style::setTheme(const std::shared_ptr<const ThemeSnapshot> &theme) {
+        assert([&]{ return theme != nullptr; }, "Style theme can't be null");
+        this->theme = theme;
     }
 }
@@ -9,8 +9,11 @@ export module lysa.ui.style;
 import std;
 import lysa.context;
 import lysa.rect;
+import lysa.types;
 import lysa.resources.font;
-import lysa.renderers.vector_2d;
+import lysa.ui.draw_sink;
+import lysa.ui.resource_descriptor;
+import lysa.ui.theme_file;
 import lysa.ui.uiresource;
 import lysa.ui.widget;
 
@@ -21,6 +24,69 @@ namespace lysa::ui {
      */
     export class Style  {
     public:
+        /**
+         * Style options, by name.
+         */
+        using Options = std::unordered_map<std::string, std::string>;
+
+        /**
+         * Immutable compiled form of a set of style options.
+         *
+         * Snapshots are produced by a style and can be shared between styles of the same kind :
+         * switching themes is a pointer swap, without parsing the options again.
+         * The values of the binary theme are used in place, only the overriding options are kept as strings.
+         */
+        class ThemeSnapshot {
+        public:
+            /**
+             * Creates a snapshot.
+             * @param options Options, overriding the values of the binary theme.
+             * @param file Optional binary theme.
+             */
+            explicit ThemeSnapshot(const Options& options, const std::shared_ptr<const ThemeFile>& file = nullptr);
+
+            virtual ~ThemeSnapshot() = default;
+
+            /**
+             * Returns the options overriding the binary theme values, without the binary theme values.
+             */
+            const Options& getOptions() const { return options; }
+
+            /**
+             * Returns an option value, from the overriding options or else from the binary theme.
+             * @param name Option name.
+             * @return The option value as a string, empty if not defined.
+             */
+            std::string getOption(const std::string& name) const;
+
+            /**
+             * Returns the binary theme this snapshot was compiled from, if any.
+             */
+            std::shared_ptr<const ThemeFile> getFile() const { return file; }
+
+        private:
+            const std::shared_ptr<const ThemeFile> file;
+            const Options options;
+        };
+
+        /**
+         * Style specific drawing, resizing & resources functions for a widget type.
+         *
+         * Each widget type registers its functions once per style, and each widget
+         * caches the entry for its type when added to a parent, so drawing & resizing
+         * are direct calls without any type switch or RTTI.
+         */
+        struct TypeHooks {
+            using Draw = void(*)(const Style&, const Widget&, const UIResource&, DrawSink &);
+            using Resize = void(*)(const Style&, Widget&, Rect&, const UIResource&);
+            using Resource = void(*)(Style&, Widget&, const UIResource&);
+
+            Draw drawBefore{nullptr};   //! Draws the widget before drawing the children
+            Draw drawAfter{nullptr};    //! Draws the widget after drawing the children
+            Resize resize{nullptr};     //! Adjusts the widget size to style specific constraints
+            Resource resource{nullptr}; //! Creates the style specific children resources
+        };
+
         /**
          * Constructor.
          */
@@ -30,20 +96,72 @@ namespace lysa::ui {
 
         /**
          * Creates a new UI drawing style renderer.
-         * @param name Style name (e.g., "vector").
+         * @param name Style name : "vector" or "pixmap". The "pixmap" style needs a draw sink supporting
+         * texture regions, with other sinks like the default RendererDrawSink it logs a warning and draws like "vector".
+         * @param theme Optional binary theme used instead of the style defaults.
          * @return Shared pointer to the created style.
          */
-        static std::shared_ptr<Style> create(const std::string & name= "vector");
+        static std::shared_ptr<Style> create(
+            const std::string & name= "vector",
+            const std::shared_ptr<const ThemeFile>& theme = nullptr);
+
+        /**
+         * Registers the drawing, resizing & resources functions of a widget type.
+         *
+         * Can be used for built-in types as well as for user defined types (Widget::CUSTOM and above).
+         * Widgets already created with this type use the new functions.
+         * @param type Widget type.
+         * @param hooks Functions for this type, null functions are ignored.
+         */
+        void registerType(Widget::Type type, const TypeHooks& hooks);
+
+        /**
+         * Returns the functions registered for a widget type.
+         *
+         * The returned reference stays valid for the lifetime of the style.
+         */
+        const TypeHooks& getHooks(Widget::Type type);
 
         /**
          * Create a resource from a resources description string.
          * @param widget Widget to associate resources with.
          * @param resources String describing the resources.
          */
-        virtual void addResource(Widget &widget, const std::string &resources) = 0;
+        void addResource(Widget &widget, const std::string &resources);
+
+        /**
+         * Create a resource from an already parsed resources description.
+         * @param widget Widget to associate resources with.
+         * @param resources Parsed resources description.
+         */
+        void addResource(Widget &widget, const ResourceDescriptor &resources);
+
+        /**
+         * Associates an already interned resource with a widget.
+         * @param widget Widget to associate resources with.
+         * @param resource Resource returned by getResource().
+         */
+        void addResource(Widget &widget, const std::shared_ptr<const UIResource> &resource);
+
+        /**
+         * Returns the shared, immutable resource for a resources description string.
+         *
+         * Resources are parsed once per style and per description string, then shared
+         * between all the widgets using the same description.
+         * @param resources String describing the resources.
+         */
+        std::shared_ptr<const UIResource> getResource(const std::string &resources);
+
+        /**
+         * Returns the shared, immutable resource for an already parsed resources description.
+         * @param resources Parsed resources description.
+         */
+        std::shared_ptr<const UIResource> getResource(const ResourceDescriptor &resources);
 
         /**
          * Sets a style-specific option.
+         *
+         * Use applyTheme() to change several options at once.
          * @param name Option name.
          * @param value Option value.
          */
@@ -57,21 +175,53 @@ namespace lysa::ui {
         std::string getOption(const std::string &name) const;
 
         /**
-         * Draws a widget.
+         * Changes several style-specific options, compiling the resulting theme only once.
+         * @param options Options to change, other options keep their current value.
+         */
+        void applyTheme(const Options &options);
+
+        /**
+         * Memory-maps a binary theme file and makes it the current theme.
+         * @param path Path of the binary theme file.
+         */
+        void loadTheme(const std::string &path);
+
+        /**
+         * Compiles a set of options into a theme snapshot, without changing the current theme.
+         * @param options Options to compile, missing options use the binary theme values or the style defaults.
+         * @param file Optional binary theme.
+         */
+        virtual std::shared_ptr<const ThemeSnapshot> compileTheme(
+            const Options &options,
+            const std::shared_ptr<const ThemeFile> &file = nullptr) const = 0;
+
+        /**
+         * Sets the current theme.
+         * @param theme A snapshot compiled by a style of the same kind.
+         */
+        virtual void setTheme(const std::shared_ptr<const ThemeSnapshot> &theme);
+
+        /**
+         * Returns the current theme.
+         */
+        std::shared_ptr<const ThemeSnapshot> getTheme() const { return theme; }
+
+        /**
+         * Draws a widget using the functions registered for its type.
          * @param widget Widget to draw.
          * @param resources Resources used for drawing this widget.
-         * @param render The 2D renderer.
+         * @param render Destination of the drawing primitives.
          * @param when True = before drawing children, False = after.
          */
-        virtual void draw(const Widget &widget, UIResource &resources, Vector2DRenderer &render, bool when) const = 0;
+        void draw(const Widget &widget, const UIResource &resources, DrawSink &render, bool when);
 
         /**
-         * Adjusts a widget size to style specific constraints.
+         * Adjusts a widget size to style specific constraints using the functions registered for its type.
          * @param widget The widget being resized.
          * @param rect The rectangle to adjust.
          * @param resources The widget's UI resources.
          */
-        virtual void resize(Widget &widget, Rect &rect, UIResource &resources) = 0;
+        void resize(Widget &widget, Rect &rect, const UIResource &resources);
 
         /**
          * Returns the default font for the style.
@@ -83,18 +233,21 @@ namespace lysa::ui {
 
         virtual void init() {}
 
-        virtual void updateOptions() = 0;
+        /**
+         * Creates the style resource of a description, called once per distinct description string.
+         */
+        virtual std::shared_ptr<const UIResource> createResource(const ResourceDescriptor &resources) const = 0;
+
+        /**
+         * Associates a resource with a widget.
+         */
+        virtual void applyResource(Widget &widget, const std::shared_ptr<const UIResource> &resource) = 0;
 
     private:
-        class StyleOption {
-        public:
-            std::string name;
-            std::string value;
-            explicit StyleOption(const std::string &name):
-                name{std::move(name)} {
-            }
-        };
-
-        std::list<std::shared_ptr<StyleOption>> options;
+        std::shared_ptr<const ThemeSnapshot> theme;
+        // Node based container : references to the entries are cached by the widgets
+        std::unordered_map<uint32, TypeHooks> hooks;
+        // Keys are views on the strings owned by the resources
+        std::unordered_map<std::string_view, std::shared_ptr<const UIResource>> internedResources;
     };
 }
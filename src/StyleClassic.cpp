@@ -6,190 +6,116 @@
 */
 module lysa.ui.style_classic;
 
+import lysa.exception;
 import lysa.types;
+import lysa.ui.texture_atlas;
 import lysa.utils;
-import lysa.ui.image;
 
 namespace lysa::ui {
 
-    void StyleClassic::updateOptions() {
-        focus = extractColor("color_focus", 0.1f, 0.1f, 0.1f);
-        fgUp = extractColor("color_foreground_up", 0.4,0.6,0.7, 1.0f);
-        fgDown = extractColor("color_foreground_down", 0.65f, 0.86f, 0.86f, 1.0f);
-        shadowDark = extractColor("color_shadow_dark", 0.25f,0.25f,0.25f, 1.0f);
-        shadowBright = extractColor("color_shadow_bright", 0.9f,0.9f,0.9f, 1.0f);
-        /*XXXX
-        if (texture != nullptr) { delete texture; }
-        if (Option("texture").Len() > 0) {
-            DatatypePixmap dtype;
-            texture = new GTexture(dtype.Load(Option("texture")),
-                                   background);
-        }*/
-    }
-
-    void StyleClassic::draw(const Widget &widget, UIResource &resources, Vector2DRenderer &renderer, const bool before) const {
-        auto &res = static_cast<StyleClassicResource &>(resources);
-        if (!widget.isVisible()) {
-            return;
-        }
-        if (before) {
-            switch (widget.getType()) {
-                // case Widget::TEXTEDIT:
-                // case Widget::UPDOWN:
-                // case Widget::PROGRESSBAR:
-            case Widget::PANEL:
-                drawPanel((Panel &)widget, res, renderer);
-                break;
-            case Widget::BOX:
-                // case Widget::SCROLLBOX:
-                drawBox(widget, res, renderer, false);
-                break;
-            case Widget::LINE:
-                drawLine((Line &)widget, res, renderer);
-                break;
-            case Widget::BUTTON:
-                drawButton((Button &)widget, res, renderer);
-                break;
-            case Widget::TOGGLEBUTTON:
-                drawToggleButton((ToggleButton &)(CheckWidget &)widget, res, renderer);
-                break;
-            case Widget::TEXT:
-                drawText((Text &)widget, res, renderer);
-                break;
-            case Widget::FRAME:
-                drawFrame((Frame &)widget, res, renderer);
-                break;
-            case Widget::IMAGE: {
-                auto &pic = dynamic_cast<const Image &>(widget);
-                if (pic.getImage()) {
-                    renderer.setPenColor(pic.getColor());
-                    renderer.drawFilledRect(widget.getRect(), pic.getImage()->id);
-                }
-            }
-                /*case Widget::GRIDCELL:
-                    DrawGridCell((GGridCell&)W, D, res);
-                    break;
-                case Widget::ARROW:
-                    DrawArrow((GArrow&)W, D, res);
-                    break;
-                case Widget::CHECKMARK:
-                    DrawCheckmark((GCheckmark&)W, D, res);
-                    break;
-                case Widget::SELECTION:
-                    DrawSelection((GSelection&)W, D, res);
-                    break;
-                case Widget::TRACKBAR:
-                    DrawTrackBar((GTrackBar&)W, D, res);
-                    break;
-                case Widget::ROUNDBUTTON:
-                    DrawRoundButton((GRoundButton&)W, D, res);
-                    break;
-                case Widget::TABBUTTON:
-                    DrawTabButton((GTabButton&)W, D, res);
-                    break;
-
-                    break;*/
-            default:
-                break;
+    StyleClassic::Theme::Theme(const Options& options, const std::shared_ptr<const ThemeFile>& file):
+        ThemeSnapshot{options, file} {
+        // Same order as the ThemeFile slots
+        static constexpr std::array<float4 Theme::*, ThemeFile::COLOR_COUNT> colors{
+            &Theme::focus, &Theme::shadowDark, &Theme::shadowBright, &Theme::fgUp, &Theme::fgDown,
+        };
+        static constexpr std::array<float Theme::*, ThemeFile::METRIC_COUNT> metrics{
+            &Theme::boxBorder, &Theme::frameBorder,
+        };
+        // Binary theme values are used in place, only the overriding options are parsed
+        for (auto slot = 0u; slot < ThemeFile::COLOR_COUNT; slot++) {
+            if (file && file->hasColor(static_cast<ThemeFile::Color>(slot))) {
+                this->*colors[slot] = file->getColor(static_cast<ThemeFile::Color>(slot));
             }
-        } else {
-            switch (widget.getType()) {
-                case Widget::TEXTEDIT:
-                    drawTextEdit((TextEdit&)widget, renderer);
-                    break;
-                /*case Widget::PROGRESSBAR:
-                    DrawProgressBar((GProgressBar&)W, D, res, R);
-                    break;
-                case Widget::TABS:
-                    DrawTabs((GTabs&)W, D, res, R);
-                    break;*/
-            default:
-                break;
+            this->*colors[slot] = extractColor(options, ThemeFile::COLOR_NAMES[slot], this->*colors[slot]);
+        }
+        for (auto slot = 0u; slot < ThemeFile::METRIC_COUNT; slot++) {
+            if (file && file->hasMetric(static_cast<ThemeFile::Metric>(slot))) {
+                this->*metrics[slot] = file->getMetric(static_cast<ThemeFile::Metric>(slot));
             }
+            this->*metrics[slot] = extractMetric(options, ThemeFile::METRIC_NAMES[slot], this->*metrics[slot]);
         }
     }
 
-    void StyleClassic::addResource(Widget &widget, const std::string &resources) {
-        const auto& res = std::make_shared<StyleClassicResource>(resources);
-        widget.setResource(res);
-        widget._setSize(res->width, res->height);
-        switch (widget.getType()) {
-        case Widget::SCROLLBAR:
-            static_cast<ScrollBar &>(widget).setResources(",,LOWERED", ",,FLAT," + to_string(fgDown));
-            break;
-        case Widget::TREEVIEW:
-            static_cast<TreeView &>(widget).setResources(",,LOWERED", "18,18,RAISED", "");
-            break;
-        case Widget::TEXTEDIT:
-            static_cast<TextEdit&>(widget).setResources(resources);
-            break;
+    std::shared_ptr<const Style::ThemeSnapshot> StyleClassic::compileTheme(
+        const Options &options,
+        const std::shared_ptr<const ThemeFile> &file) const {
+        return std::make_shared<const Theme>(options, file);
+    }
 
-            // XXX
-            /*case Widget::UPDOWN:
-                ((GUpDown&)W).SetResources(RES, RES);
-                break;
-            case Widget::TRACKBAR:
-                ((GTrackBar&)W).SetResources("12,12,RAISED");
-                break;
-            case Widget::PROGRESSBAR:
-                ((GProgressBar&)W).SetResources(RES);
-                break;
-            case Widget::LISTBOX:
-                ((GListBox&)W).SetResources(std::string(",,LOWERED") + (res->flat ? ",FLAT" : ""),
-                                            std::string("18,18,RAISED") + (res->flat ? ",FLAT" : ""),
-                                            "");
-                break;
-            case Widget::SCROLLBOX:
-                ((GScrollBox&)W).SetResources(std::string(",,LOWERED") + (res->flat ? ",FLAT" : ""),
-                                              std::string("18,18,RAISED") + (res->flat ? ",FLAT" : ""),
-                                              std::string("18,18,RAISED") + (res->flat ? ",FLAT" : ""));
-                break;
-            case Widget::TABS:
-                ((GTabs&)W).SetResources(",,RAISED");
-                break;
-            case Widget::GRID:
-                ((GGrid&)W).SetResources(",,LOWERED");*/
-        default:
-            break;
-        }
+    void StyleClassic::setTheme(const std::shared_ptr<const ThemeSnapshot> &theme) {
+        assert([&]{ return dynamic_cast<const Theme*>(theme.get()) != nullptr; }, "Theme not compiled by a classic style");
+        Style::setTheme(theme);
+        this->theme = static_cast<const Theme*>(theme.get());
     }
 
-    void StyleClassic::resize(Widget &widget, Rect &rect, UIResource &) {
-        switch (widget.getType()) {
-        case Widget::BOX:
-        case Widget::BUTTON:
-            // case Widget::TABBUTTON:
-            widget.setVBorder(2);
-            widget.setHBorder(2);
-            break;
-        case Widget::FRAME: {
-            widget.setHBorder(4);
-            float w, h;
-            widget.getFont()->getSize(
-                static_cast<Frame &>(widget).getTitle(),
-                widget.getFontScale(), w, h); // TODO text scale in Frame
-            widget.setVBorder(h - 2);
-        } break;
-            /*case Widget::LINE:
-            {
-                GLine &L = (GLine&)W;
-                if (L.Style() == GLine::HORIZ) {
-                    R.height = 2;
-                }
-                else if (L.Style() == GLine::VERT) {
-                    R.width = 2;
-                }
-            }
-                break;*/
-        default:
-            break;
-        }
+    void StyleClassic::init() {
+        registerType(Widget::PANEL, {.drawBefore = drawHook<Panel, &StyleClassic::drawPanel>});
+        registerType(Widget::BOX, {
+            .drawBefore = drawHook<Widget, &StyleClassic::drawBox>,
+            .resize = resizeBox});
+        registerType(Widget::LINE, {.drawBefore = drawHook<Line, &StyleClassic::drawLine>});
+        registerType(Widget::BUTTON, {
+            .drawBefore = drawHook<Button, &StyleClassic::drawButton>,
+            .resize = resizeBox});
+        registerType(Widget::TOGGLEBUTTON, {.drawBefore = drawHook<ToggleButton, &StyleClassic::drawToggleButton>});
+        registerType(Widget::TEXT, {.drawBefore = drawHook<Text, &StyleClassic::drawText>});
+        registerType(Widget::FRAME, {
+            .drawBefore = drawHook<Frame, &StyleClassic::drawFrame>,
+            .resize = resizeFrame});
+        registerType(Widget::IMAGE, {.drawBefore = drawHook<Image, &StyleClassic::drawImage>});
+        registerType(Widget::TEXTEDIT, {
+            .drawAfter = drawHook<TextEdit, &StyleClassic::drawTextEdit>,
+            .resource = resourceTextEdit});
+        registerType(Widget::SCROLLBAR, {.resource = resourceScrollBar});
+        registerType(Widget::TREEVIEW, {.resource = resourceTreeView});
+    }
+
+    std::shared_ptr<const UIResource> StyleClassic::createResource(const ResourceDescriptor &resources) const {
+        return std::make_shared<const StyleClassicResource>(resources);
+    }
+
+    void StyleClassic::applyResource(Widget &widget, const std::shared_ptr<const UIResource> &resource) {
+        widget.setResource(resource);
+        const auto& res = static_cast<const StyleClassicResource&>(*resource);
+        widget._setSize(res.width, res.height);
+        const auto& typeHooks = getHooks(widget.getType());
+        if (typeHooks.resource) { typeHooks.resource(*this, widget, *resource); }
+    }
+
+    void StyleClassic::resourceScrollBar(Style &style, Widget &widget, const UIResource &) {
+        static_cast<ScrollBar &>(widget).setResources(
+            ",,LOWERED",
+            ",,FLAT," + to_string(static_cast<StyleClassic &>(style).theme->fgDown));
+    }
+
+    void StyleClassic::resourceTreeView(Style &, Widget &widget, const UIResource &) {
+        static_cast<TreeView &>(widget).setResources(",,LOWERED", "18,18,RAISED", "");
+    }
+
+    void StyleClassic::resourceTextEdit(Style &, Widget &widget, const UIResource &resources) {
+        static_cast<TextEdit &>(widget).setResources(resources.getResource());
+    }
+
+    void StyleClassic::resizeBox(const Style &style, Widget &widget, Rect &, const UIResource &) {
+        const auto border = static_cast<const StyleClassic &>(style).theme->boxBorder;
+        widget.setVBorder(border);
+        widget.setHBorder(border);
     }
 
-    float4 StyleClassic::extractColor(const std::string &OPT, const float R, const float G, const float B, const float A) const {
-        const std::string opt = getOption(OPT);
-        if (!opt.empty()) {
-            const auto &rgb = split(opt, ',');
+    void StyleClassic::resizeFrame(const Style &style, Widget &widget, Rect &, const UIResource &) {
+        widget.setHBorder(static_cast<const StyleClassic &>(style).theme->frameBorder);
+        float w, h;
+        widget.getFont()->getSize(
+            static_cast<Frame &>(widget).getTitle(),
+            widget.getFontScale(), w, h); // TODO text scale in Frame
+        widget.setVBorder(h - 2);
+    }
+
+    float4 StyleClassic::extractColor(const Options &options, const std::string_view OPT, const float4 &value) {
+        const auto it = options.find(std::string{OPT});
+        if (it != options.end() && !it->second.empty()) {
+            const auto &rgb = split(it->second, ',');
             if (rgb.size() == 3) {
                 return float4{stof(std::string{rgb[0]}), stof(std::string{rgb[1]}), stof(std::string{rgb[2]}), 1.0f};
             }
@@ -197,24 +123,36 @@ namespace lysa::ui {
                 return float4{stof(std::string{rgb[0]}), stof(std::string{rgb[1]}), stof(std::string{rgb[2]}), stof(std::string{rgb[3]})};
             }
         }
-        return float4{R, G, B, A};
+        return value;
+    }
+
+    float StyleClassic::extractMetric(const Options &options, const std::string_view OPT, const float value) {
+        const auto it = options.find(std::string{OPT});
+        if (it != options.end() && !it->second.empty()) {
+            return stof(it->second);
+        }
+        return value;
     }
 
-    void StyleClassic::drawPanel(const Panel &widget, StyleClassicResource &resources, Vector2DRenderer &renderer) const {
+    void StyleClassic::drawPanel(const Panel &widget, const StyleClassicResource &resources, DrawSink &renderer) const {
         if (widget.isDrawBackground()) {
-            auto c = resources.customColor ? resources.color : fgDown;
+            auto c = resources.customColor ? resources.color : theme->fgDown;
             c.a = widget.getTransparency();
             renderer.setPenColor(c);
             renderer.drawFilledRect(widget.getRect());
-            // texture->Draw(D, W.Rect());
         }
     }
 
-    void StyleClassic::drawBox(
+    void StyleClassic::drawBox(const Widget &widget, const StyleClassicResource &resources, DrawSink &renderer) const {
+        drawBevel(widget, resources, renderer, resources.style, false);
+    }
+
+    void StyleClassic::drawBevel(
         const Widget &widget,
         const StyleClassicResource &resources,
-        Vector2DRenderer &renderer,
-        const bool pushable) const {
+        DrawSink &renderer,
+        const StyleClassicResource::Style style,
+        const bool pushed) const {
         if ((widget.getWidth() < 4) || (widget.getHeight() < 4)) {
             return;
         }
@@ -223,23 +161,23 @@ namespace lysa::ui {
         const auto w= widget.getRect().width - 1;
         const auto h= widget.getRect().height - 1;
         if (widget.isDrawBackground()) {
-            if (pushable && widget.isPushed()) {
-                auto fd= fgDown;
+            if (pushed) {
+                auto fd= theme->fgDown;
                 fd.a  -= 1.0f-widget.getTransparency();
                 renderer.setPenColor(fd);
             } else {
-                auto fu= resources.customColor ? resources.color : fgUp;
+                auto fu= resources.customColor ? resources.color : theme->fgUp;
                 fu.a  -= 1.0f-widget.getTransparency();
                 renderer.setPenColor(fu);
             }
             renderer.drawFilledRect(x, y, w, h, INVALID_ID);
         }
-        if (resources.style != StyleClassicResource::FLAT) {
-            auto sb = shadowBright;
+        if (style != StyleClassicResource::FLAT) {
+            auto sb = theme->shadowBright;
             sb.a    = widget.getTransparency();
-            auto sd = shadowDark;
+            auto sd = theme->shadowDark;
             sd.a    = widget.getTransparency();
-            switch (resources.style) {
+            switch (style) {
             case StyleClassicResource::LOWERED:
                 renderer.setPenColor(sd);
                 break;
@@ -251,7 +189,7 @@ namespace lysa::ui {
             }
             renderer.drawLine({x, y + h}, {x + w, y + h}); // top
             renderer.drawLine({x, y}, {x, y + h}); // left
-            switch (resources.style) {
+            switch (style) {
             case StyleClassicResource::RAISED:
                 renderer.setPenColor(sd);
                 break;
@@ -266,12 +204,12 @@ namespace lysa::ui {
         }
     }
 
-    void StyleClassic::drawLine(const Line &widget, const StyleClassicResource &resource, Vector2DRenderer &renderer) const {
+    void StyleClassic::drawLine(const Line &widget, const StyleClassicResource &resource, DrawSink &renderer) const {
         float4 color;
         if (resource.customColor) {
             color = resource.color;
         } else {
-            color = resource.style == StyleClassicResource::RAISED ? shadowDark : shadowBright;
+            color = resource.style == StyleClassicResource::RAISED ? theme->shadowDark : theme->shadowBright;
         }
         color.a -= 1.0f - widget.getTransparency();
         auto& rect = widget.getRect();
@@ -283,23 +221,26 @@ namespace lysa::ui {
         }
     }
 
-    void StyleClassic::drawButton(const Button &widget, StyleClassicResource &resource, Vector2DRenderer &renderer) const {
-        resource.style = widget.isPushed() ? StyleClassicResource::LOWERED : StyleClassicResource::RAISED;
-        drawBox(widget, resource, renderer, true);
+    void StyleClassic::drawButton(const Button &widget, const StyleClassicResource &resource, DrawSink &renderer) const {
+        drawBevel(
+            widget,
+            resource,
+            renderer,
+            widget.isPushed() ? StyleClassicResource::LOWERED : StyleClassicResource::RAISED,
+            widget.isPushed());
     }
 
-    void StyleClassic::drawToggleButton(ToggleButton &widget, StyleClassicResource &resources, Vector2DRenderer &renderer) const {
-        if (widget.getState() == CheckWidget::CHECK) {
-            resources.style = StyleClassicResource::LOWERED;
-            widget.setPushed(true);
-        } else {
-            resources.style = StyleClassicResource::RAISED;
-            widget.setPushed(false);
-        }
-        drawBox(widget, resources, renderer, true);
+    void StyleClassic::drawToggleButton(const ToggleButton &widget, const StyleClassicResource &resources, DrawSink &renderer) const {
+        const auto checked = widget.getState() == CheckWidget::CHECK;
+        drawBevel(
+            widget,
+            resources,
+            renderer,
+            checked ? StyleClassicResource::LOWERED : StyleClassicResource::RAISED,
+            checked);
     }
 
-    void StyleClassic::drawText(const Text &widget, const StyleClassicResource &resources, Vector2DRenderer &renderer) const {
+    void StyleClassic::drawText(const Text &widget, const StyleClassicResource &resources, DrawSink &renderer) const {
         renderer.setPenColor(
             resources.customColor ? resources.color :
             float4{widget.getTextColor().r, widget.getTextColor().g, widget.getTextColor().b, widget.getTransparency()});
@@ -311,20 +252,19 @@ namespace lysa::ui {
             widget.getRect().y);
     }
 
-    void StyleClassic::drawFrame(Frame &widget, StyleClassicResource &resources, Vector2DRenderer &renderer) const {
+    void StyleClassic::drawFrame(const Frame &widget, const StyleClassicResource &resources, DrawSink &renderer) const {
         if ((widget.getWidth() < 4) || (widget.getHeight() < 4)) {
             return;
         }
-        constexpr int32 LEFTOFFSET = 8;
         float l = widget.getRect().x;
         float b =  widget.getRect().y;
         float w = widget.getRect().width;
         float h = widget.getRect().height;
         float4 c1;
         float4 c2;
-        auto sb = shadowBright;
+        auto sb = theme->shadowBright;
         sb.a = widget.getTransparency();
-        auto sd = shadowDark;
+        auto sd = theme->shadowDark;
         sd.a = widget.getTransparency();
         switch (resources.style) {
         case StyleClassicResource::RAISED:
@@ -344,19 +284,19 @@ namespace lysa::ui {
         widget.getFont()->getSize(widget.getTitle(), widget.getFontScale(), fw, fh);
         // fw /= renderer.getAspectRatio();
         renderer.setPenColor(c2);
-        if ((!widget.getTitle().empty()) && (widget.getWidth() >= (fw + LEFTOFFSET)) && (widget.getHeight() >= fh)) {
+        if ((!widget.getTitle().empty()) && (widget.getWidth() >= (fw + FRAME_TITLE_OFFSET)) && (widget.getHeight() >= fh)) {
             renderer.drawLine(
                 {l, b + h},
-                {l + LEFTOFFSET, b + h});
+                {l + FRAME_TITLE_OFFSET, b + h});
             renderer.drawLine(
-                {l + fw + LEFTOFFSET + 1, b + h},
+                {l + fw + FRAME_TITLE_OFFSET + 1, b + h},
                 {l + w, b + h});
             renderer.setPenColor(float4{widget.getTitleColor().r, widget.getTitleColor().g, widget.getTitleColor().b, widget.getTransparency()});
             renderer.drawText(
                 widget.getTitle(),
                 *widget.getFont(),
                 widget.getFontScale(),
-                l + LEFTOFFSET,
+                l + FRAME_TITLE_OFFSET,
                  (b + h) - (fh / 2) - widget.getFont()->getDescender()*widget.getFontScale());
             renderer.setPenColor(c2);
         } else {
@@ -368,7 +308,23 @@ namespace lysa::ui {
         renderer.drawLine({l, b}, {l + w, b}); // bottom
     }
 
-    void StyleClassic::drawTextEdit(const TextEdit& widget, Vector2DRenderer& renderer) const {
+    void StyleClassic::drawImage(const Image &widget, const StyleClassicResource &, DrawSink &renderer) const {
+        if (const auto* atlas = widget.getAtlas()) {
+            renderer.setPenColor(widget.getColor());
+            if (renderer.supportsTextureRegions()) {
+                const auto& region = widget.getRegion();
+                renderer.drawTexturedRect(widget.getRect(), atlas->getPageTexture(region.page), region.uv);
+            } else {
+                // The source image is its own texture
+                renderer.drawFilledRect(widget.getRect(), widget.getAtlasSource());
+            }
+        } else if (widget.getImage()) {
+            renderer.setPenColor(widget.getColor());
+            renderer.drawFilledRect(widget.getRect(), widget.getImage()->id);
+        }
+    }
+
+    void StyleClassic::drawTextEdit(const TextEdit &widget, const StyleClassicResource &, DrawSink &renderer) const {
         if (widget.isFocused() && (!widget.isReadOnly())) {
             float w, h;
             const auto txt = widget.getDisplayedText().substr(
@@ -378,7 +334,7 @@ namespace lysa::ui {
             h = widget.getTextBox()->getHeight();
             auto l = widget.getTextBox()->getRect().x + w;
             auto t =  widget.getTextBox()->getRect().y - 2 ;
-            // renderer.setPenColor(shadowDark);
+            // renderer.setPenColor(theme->shadowDark);
             renderer.setPenColor({1.0, 0.0, 0.0, 1.0});
             renderer.drawLine({l - 2, t}, {l - 2 + 5, t});
             renderer.drawLine({l - 2, t + h}, {l - 2 + 5, t + h});
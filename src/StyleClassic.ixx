@@ -6,20 +6,24 @@
 */
 export module lysa.ui.style_classic;
 
+import std;
 import lysa.math;
 import lysa.rect;
-import lysa.renderers.vector_2d;
+import lysa.ui.draw_sink;
 import lysa.ui.button;
 import lysa.ui.check_widget;
 import lysa.ui.frame;
+import lysa.ui.image;
 import lysa.ui.line;
 import lysa.ui.panel;
+import lysa.ui.resource_descriptor;
 import lysa.ui.uiresource;
 import lysa.ui.scroll_bar;
 import lysa.ui.style;
 import lysa.ui.style_classic_resource;
 import lysa.ui.text;
 import lysa.ui.text_edit;
+import lysa.ui.theme_file;
 import lysa.ui.toggle_button;
 import lysa.ui.tree_view;
 import lysa.ui.widget;
@@ -31,41 +35,88 @@ export namespace lysa::ui {
      */
     class StyleClassic : public Style {
     public:
+        /**
+         * Compiled options of the classic style.
+         */
+        class Theme : public ThemeSnapshot {
+        public:
+            float4 focus{0.1f, 0.1f, 0.1f, 1.0f};         //! Focus color (`color_focus`)
+            float4 shadowDark{0.25f, 0.25f, 0.25f, 1.0f}; //! Dark side of the 3D borders (`color_shadow_dark`)
+            float4 shadowBright{0.9f, 0.9f, 0.9f, 1.0f};  //! Bright side of the 3D borders (`color_shadow_bright`)
+            float4 fgUp{0.4f, 0.6f, 0.7f, 1.0f};          //! Boxes background (`color_foreground_up`)
+            float4 fgDown{0.65f, 0.86f, 0.86f, 1.0f};     //! Panels & pushed boxes background (`color_foreground_down`)
+            float boxBorder{2};                           //! Boxes & buttons borders size (`box_border`)
+            float frameBorder{4};                         //! Frames horizontal borders size (`frame_border`)
+
+            /**
+             * Compiles a theme, options override the binary theme values which override the defaults.
+             */
+            Theme(const Options& options, const std::shared_ptr<const ThemeFile>& file);
+        };
+
         ~StyleClassic() override = default;
 
-        void draw(const Widget &widget, UIResource &resources, Vector2DRenderer &renderer, bool before) const override;
+        std::shared_ptr<const ThemeSnapshot> compileTheme(
+            const Options &options,
+            const std::shared_ptr<const ThemeFile> &file = nullptr) const override;
+
+        void setTheme(const std::shared_ptr<const ThemeSnapshot> &theme) override;
+
+    protected:
+        void init() override;
+
+        std::shared_ptr<const UIResource> createResource(const ResourceDescriptor &resources) const override;
+
+        void applyResource(Widget &widget, const std::shared_ptr<const UIResource> &resource) override;
+
+    protected:
+        static constexpr float FRAME_TITLE_OFFSET{8}; // Space between the frame left side & the title
+
+        // Current theme, owned by the base class
+        const Theme* theme{nullptr};
+
+        static float4 extractColor(const Options &options, std::string_view OPT, const float4 &value);
+
+        static float extractMetric(const Options &options, std::string_view OPT, float value);
+
+        // Adapts a typed drawing method to the Style::TypeHooks::Draw signature
+        template<typename T, void (StyleClassic::*method)(const T &, const StyleClassicResource &, DrawSink &) const>
+        static void drawHook(const Style &style, const Widget &widget, const UIResource &resources, DrawSink &renderer) {
+            (static_cast<const StyleClassic &>(style).*method)(
+                static_cast<const T &>(widget),
+                static_cast<const StyleClassicResource &>(resources),
+                renderer);
+        }
+
+        static void resizeBox(const Style &, Widget &, Rect &, const UIResource &);
+
+        static void resizeFrame(const Style &, Widget &, Rect &, const UIResource &);
 
-        void addResource(Widget &widget, const std::string &resources) override;
+        static void resourceScrollBar(Style &, Widget &, const UIResource &);
 
-        void resize(Widget &widget, Rect &rect, UIResource &resources) override;
+        static void resourceTreeView(Style &, Widget &, const UIResource &);
 
-    private:
-        float4 focus{};
-        float4 shadowDark{};
-        float4 shadowBright{};
-        float4 fgUp{};
-        float4 fgDown{};
-        // GTexture	*texture;
+        static void resourceTextEdit(Style &, Widget &, const UIResource &);
 
-        void updateOptions() override;
+        void drawPanel(const Panel &, const StyleClassicResource &, DrawSink &) const;
 
-        float4 extractColor(const std::string &OPT, float R, float G, float B, float A = 1.0f) const;
+        void drawBox(const Widget &, const StyleClassicResource &, DrawSink &) const;
 
-        void drawPanel(const Panel &, StyleClassicResource &, Vector2DRenderer &) const;
+        void drawBevel(const Widget &, const StyleClassicResource &, DrawSink &, StyleClassicResource::Style, bool pushed) const;
 
-        void drawBox(const Widget &, const StyleClassicResource &, Vector2DRenderer &, bool pushable) const;
+        void drawLine(const Line &, const StyleClassicResource &, DrawSink &) const;
 
-        void drawLine(const Line &, const StyleClassicResource &, Vector2DRenderer &) const;
+        void drawButton(const Button &, const StyleClassicResource &, DrawSink &) const;
 
-        void drawButton(const Button &, StyleClassicResource &, Vector2DRenderer &) const;
+        void drawToggleButton(const ToggleButton &, const StyleClassicResource &, DrawSink &) const;
 
-        void drawToggleButton(ToggleButton &, StyleClassicResource &, Vector2DRenderer &) const;
+        void drawText(const Text &, const StyleClassicResource &, DrawSink &) const;
 
-        void drawText(const Text &, const StyleClassicResource &, Vector2DRenderer &) const;
+        void drawFrame(const Frame &, const StyleClassicResource &, DrawSink &) const;
 
-        void drawFrame(Frame &, StyleClassicResource &, Vector2DRenderer &) const;
+        void drawImage(const Image &, const StyleClassicResource &, DrawSink &) const;
 
-        void drawTextEdit(const TextEdit&, Vector2DRenderer&) const;
+        void drawTextEdit(const TextEdit &, const StyleClassicResource &, DrawSink &) const;
 
         /*void drawArrow(GArrow&, GLayoutVectorResource&, VectorRenderer&);
         void drawCheckmark(GCheckmark&, GLayoutVectorResource&, VectorRenderer&);
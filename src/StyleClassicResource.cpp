@@ -6,35 +6,29 @@
 */
 module lysa.ui.style_classic_resource;
 
-import lysa.utils;
-
 namespace lysa::ui {
 
     StyleClassicResource::StyleClassicResource(const std::string &resource) :
-        UIResource{resource} {
-        splitResString(resource);
+        StyleClassicResource{ResourceDescriptor::parse(resource)} {
     }
-    void StyleClassicResource::splitResString(const std::string &resource) {
-        const auto res = split(resource, ',');
-        if ((!res.empty()) && (!res[0].empty())) {
-            width = stof(std::string{res[0]});
-        }
-        if ((res.size() > 1) && (!res[1].empty())) {
-            height = stof(std::string{res[1]});
-        }
-        if (res.size() > 2) {
-            if (res[2] == "RAISED") {
-                style = RAISED;
-            } else if (res[2] == "LOWERED") {
-                style = LOWERED;
-            } else if (res[2] == "FLAT") {
-                style = FLAT;
-            }
-        }
-        if (res.size() > 3) {
-            color       = float4{stof(std::string{res[3]}), stof(std::string{res[4]}), stof(std::string{res[5]}), stof(std::string{res[6]})};
-            customColor = true;
+
+    StyleClassicResource::StyleClassicResource(const ResourceDescriptor &resource) :
+        UIResource{std::string{resource.source}},
+        width{resource.width},
+        height{resource.height},
+        customColor{resource.customColor},
+        color{resource.color[0], resource.color[1], resource.color[2], resource.color[3]} {
+        switch (resource.style) {
+        case ResourceDescriptor::FLAT:
+            style = FLAT;
+            break;
+        case ResourceDescriptor::LOWERED:
+            style = LOWERED;
+            break;
+        default:
+            style = RAISED;
+            break;
         }
     }
 
-}
\ No newline at end of file
+}
@@ -9,12 +9,15 @@ export module lysa.ui.style_classic_resource;
 import lysa.math;
 import lysa.types;
 
+import lysa.ui.resource_descriptor;
 import lysa.ui.uiresource;
 
 export namespace lysa::ui {
 
     /**
      * UI resources for the classic style.
+     *
+     * Instances are interned by the style and shared between widgets, they are never modified after parsing.
      */
     class StyleClassicResource : public UIResource {
     public:
@@ -27,7 +30,7 @@ export namespace lysa::ui {
             LOWERED  //! 3D lowered appearance
         };
 
-        Style style{RAISED};     //! Current style appearance
+        Style style{RAISED};     //! Style appearance
         float width{0};          //! Requested width
         float height{0};         //! Requested height
         bool customColor{false}; //! Whether a custom color is used
@@ -39,7 +42,10 @@ export namespace lysa::ui {
          */
         explicit StyleClassicResource(const std::string& resource);
 
-    private:
-        void splitResString(const std::string& resource);
+        /**
+         * Constructor.
+         * @param resource Already parsed resource description.
+         */
+        explicit StyleClassicResource(const ResourceDescriptor& resource);
     };
 }
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+module lysa.ui.style_pixmap;
+
+import lysa.exception;
+import lysa.log;
+import lysa.ui.box;
+import lysa.ui.check_widget;
+import lysa.ui.scroll_bar;
+import lysa.utils;
+
+namespace lysa::ui {
+
+    StylePixmap::Theme::Theme(const Options& options, const std::shared_ptr<const ThemeFile>& file):
+        StyleClassic::Theme{options, file} {
+        for (auto slot = 0u; slot < SLICE_COUNT; slot++) {
+            auto& region = regions[slot];
+            if (file) {
+                if (const auto* slice = file->findNineSlice(SLICE_NAMES[slot])) {
+                    region.defined = true;
+                    region.rect = float4{slice->x, slice->y, slice->width, slice->height};
+                    region.borders = float4{slice->left, slice->top, slice->right, slice->bottom};
+                }
+            }
+            // Same format as the text themes : x,y,width,height,left,top,right,bottom
+            const auto it = options.find("nine_slice." + std::string{SLICE_NAMES[slot]});
+            if (it != options.end() && !it->second.empty()) {
+                const auto &values = split(it->second, ',');
+                if (values.size() != 8) {
+                    throw Exception("Can't parse nine-slice region ", it->first, " : ", it->second);
+                }
+                auto v = std::array<float, 8>{};
+                for (auto i = 0u; i < v.size(); i++) {
+                    v[i] = stof(std::string{values[i]});
+                }
+                region.defined = true;
+                region.rect = float4{v[0], v[1], v[2], v[3]};
+                region.borders = float4{v[4], v[5], v[6], v[7]};
+            }
+        }
+    }
+
+    std::shared_ptr<const Style::ThemeSnapshot> StylePixmap::compileTheme(
+        const Options &options,
+        const std::shared_ptr<const ThemeFile> &file) const {
+        return std::make_shared<const Theme>(options, file);
+    }
+
+    void StylePixmap::setTheme(const std::shared_ptr<const ThemeSnapshot> &theme) {
+        assert([&]{ return dynamic_cast<const Theme*>(theme.get()) != nullptr; }, "Theme not compiled by a pixmap style");
+        StyleClassic::setTheme(theme);
+        pixmapTheme = static_cast<const Theme*>(theme.get());
+    }
+
+    void StylePixmap::setSkin(const lysa::Image& image) {
+        setSkin(image.id, static_cast<float>(image.getWidth()), static_cast<float>(image.getHeight()));
+    }
+
+    void StylePixmap::setSkin(const unique_id texture, const float width, const float height) {
+        assert([&]{ return texture == INVALID_ID || (width > 0.0f && height > 0.0f); }, "StylePixmap: invalid skin size");
+        skinTexture = texture;
+        skinWidth = width;
+        skinHeight = height;
+    }
+
+    void StylePixmap::init() {
+        StyleClassic::init();
+        // Only the drawing functions are replaced, the resizing & resources functions are the classic ones
+        registerType(Widget::PANEL, {.drawBefore = drawHook<Panel, &StylePixmap::drawPanel>});
+        registerType(Widget::BOX, {.drawBefore = drawHook<Widget, &StylePixmap::drawBox>});
+        registerType(Widget::BUTTON, {.drawBefore = drawHook<Button, &StylePixmap::drawButton>});
+        registerType(Widget::TOGGLEBUTTON, {.drawBefore = drawHook<ToggleButton, &StylePixmap::drawToggleButton>});
+        registerType(Widget::FRAME, {.drawBefore = drawHook<Frame, &StylePixmap::drawFrame>});
+    }
+
+    bool StylePixmap::drawSlice(
+        const Widget &widget,
+        const StyleClassicResource &resources,
+        DrawSink &renderer,
+        const Slice slice) const {
+        const auto& region = pixmapTheme->regions[slice];
+        if (skinTexture == INVALID_ID || !region.defined) {
+            return false;
+        }
+        if (!renderer.supportsTextureRegions()) {
+            std::call_once(regionsWarning, [] {
+                Log::warning("StylePixmap: the draw sink does not support texture regions, drawing like the classic style");
+            });
+            return false;
+        }
+        // The texture is modulated by the custom color of the resource, if any
+        auto tint = resources.customColor ? resources.color : float4{1.0f, 1.0f, 1.0f, 1.0f};
+        tint.a -= 1.0f - widget.getTransparency();
+        renderer.setPenColor(tint);
+        const auto& rect = region.rect;
+        const auto& borders = region.borders;
+        renderer.drawNineSlice(
+            widget.getRect(),
+            skinTexture,
+            float4{
+                rect.x / skinWidth,
+                rect.y / skinHeight,
+                (rect.x + rect.z) / skinWidth,
+                (rect.y + rect.w) / skinHeight},
+            borders,
+            float4{
+                borders.x / skinWidth,
+                borders.y / skinHeight,
+                borders.z / skinWidth,
+                borders.w / skinHeight});
+        return true;
+    }
+
+    void StylePixmap::drawPanel(const Panel &widget, const StyleClassicResource &resources, DrawSink &renderer) const {
+        if (widget.isDrawBackground() && !drawSlice(widget, resources, renderer, PANEL)) {
+            StyleClassic::drawPanel(widget, resources, renderer);
+        }
+    }
+
+    void StylePixmap::drawBox(const Widget &widget, const StyleClassicResource &resources, DrawSink &renderer) const {
+        auto slice = BOX_RAISED;
+        if (const auto* parent = widget.getParent(); parent && parent->getType() == Widget::SCROLLBAR) {
+            slice = static_cast<const ScrollBar *>(parent)->getLift() == &widget ? SCROLLBAR_LIFT : SCROLLBAR_AREA;
+        } else if (resources.style == StyleClassicResource::FLAT) {
+            slice = BOX_FLAT;
+        } else if (resources.style == StyleClassicResource::LOWERED) {
+            slice = BOX_LOWERED;
+        }
+        if (!drawSlice(widget, resources, renderer, slice)) {
+            StyleClassic::drawBox(widget, resources, renderer);
+        }
+    }
+
+    void StylePixmap::drawButton(const Button &widget, const StyleClassicResource &resources, DrawSink &renderer) const {
+        if (!drawSlice(widget, resources, renderer, widget.isPushed() ? BUTTON_DOWN : BUTTON_UP)) {
+            StyleClassic::drawButton(widget, resources, renderer);
+        }
+    }
+
+    void StylePixmap::drawToggleButton(const ToggleButton &widget, const StyleClassicResource &resources, DrawSink &renderer) const {
+        const auto checked = widget.getState() == CheckWidget::CHECK;
+        if (!drawSlice(widget, resources, renderer, checked ? BUTTON_DOWN : BUTTON_UP)) {
+            StyleClassic::drawToggleButton(widget, resources, renderer);
+        }
+    }
+
+    void StylePixmap::drawFrame(const Frame &widget, const StyleClassicResource &resources, DrawSink &renderer) const {
+        if (!drawSlice(widget, resources, renderer, FRAME)) {
+            StyleClassic::drawFrame(widget, resources, renderer);
+            return;
+        }
+        // The title is drawn over the top border of the region
+        const auto& rect = widget.getRect();
+        float fw, fh;
+        widget.getFont()->getSize(widget.getTitle(), widget.getFontScale(), fw, fh);
+        if ((!widget.getTitle().empty()) && (rect.width >= (fw + FRAME_TITLE_OFFSET)) && (rect.height >= fh)) {
+            renderer.setPenColor(float4{widget.getTitleColor().r, widget.getTitleColor().g, widget.getTitleColor().b, widget.getTransparency()});
+            renderer.drawText(
+                widget.getTitle(),
+                *widget.getFont(),
+                widget.getFontScale(),
+                rect.x + FRAME_TITLE_OFFSET,
+                (rect.y + rect.height) - (fh / 2) - widget.getFont()->getDescender() * widget.getFontScale());
+        }
+    }
+
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+export module lysa.ui.style_pixmap;
+
+import std;
+import lysa.math;
+import lysa.types;
+import lysa.resources.image;
+import lysa.ui.button;
+import lysa.ui.draw_sink;
+import lysa.ui.frame;
+import lysa.ui.panel;
+import lysa.ui.style;
+import lysa.ui.style_classic;
+import lysa.ui.style_classic_resource;
+import lysa.ui.theme_file;
+import lysa.ui.toggle_button;
+import lysa.ui.uiresource;
+import lysa.ui.widget;
+
+export namespace lysa::ui {
+
+    /**
+     * Textured style UI, drawing the panels, boxes, buttons, frames & scroll bars with
+     * nine-slice regions of a single skin texture.
+     *
+     * Each widget is drawn with one nine-slice primitive of the same texture, so consecutive
+     * widgets are batched together by the renderer. The regions are the `nine_slice.<name>`
+     * entries of the theme, with the names of SLICE_NAMES. The texture is loaded by the
+     * application, usually from the `skin` URI of the binary theme, then set with setSkin().
+     *
+     * Widgets without a region in the current theme, or all the widgets while no skin is set,
+     * are drawn like the classic style, which also draws the lines, texts, images & text edits.
+     * The regions need a draw sink supporting texture regions : the default RendererDrawSink
+     * does not, with it the skin is ignored, a warning is logged and all the widgets are drawn
+     * like the classic style.
+     */
+    class StylePixmap : public StyleClassic {
+    public:
+        /**
+         * Nine-slice regions used by the style.
+         */
+        enum Slice : uint32 {
+            PANEL,          //! Panels background (`panel`)
+            BOX_FLAT,       //! Flat boxes (`box_flat`)
+            BOX_RAISED,     //! Raised boxes (`box_raised`)
+            BOX_LOWERED,    //! Lowered boxes (`box_lowered`)
+            BUTTON_UP,      //! Released buttons & unchecked toggle buttons (`button_up`)
+            BUTTON_DOWN,    //! Pushed buttons & checked toggle buttons (`button_down`)
+            FRAME,          //! Frames (`frame`)
+            SCROLLBAR_AREA, //! Scroll bars area (`scrollbar_area`)
+            SCROLLBAR_LIFT, //! Scroll bars lift (`scrollbar_lift`)
+            SLICE_COUNT
+        };
+
+        /**
+         * Theme names of the nine-slice regions.
+         */
+        static constexpr std::array<std::string_view, SLICE_COUNT> SLICE_NAMES{
+            "panel",
+            "box_flat",
+            "box_raised",
+            "box_lowered",
+            "button_up",
+            "button_down",
+            "frame",
+            "scrollbar_area",
+            "scrollbar_lift",
+        };
+
+        /**
+         * Compiled options of the pixmap style.
+         */
+        class Theme : public StyleClassic::Theme {
+        public:
+            /**
+             * Nine-slice region of the skin texture, in texels.
+             */
+            struct Region {
+                bool defined{false};    //! False if the theme does not define this region
+                float4 rect{0.0f};      //! Position & size in the skin texture
+                float4 borders{0.0f};   //! Left, top, right & bottom borders size
+            };
+
+            std::array<Region, SLICE_COUNT> regions; //! Regions, by Slice (`nine_slice.<name>`)
+
+            /**
+             * Compiles a theme, options override the binary theme values which override the defaults.
+             */
+            Theme(const Options& options, const std::shared_ptr<const ThemeFile>& file);
+        };
+
+        ~StylePixmap() override = default;
+
+        std::shared_ptr<const ThemeSnapshot> compileTheme(
+            const Options &options,
+            const std::shared_ptr<const ThemeFile> &file = nullptr) const override;
+
+        void setTheme(const std::shared_ptr<const ThemeSnapshot> &theme) override;
+
+        /**
+         * Sets the skin texture used by the nine-slice regions.
+         */
+        void setSkin(const lysa::Image& image);
+
+        /**
+         * Sets the skin texture used by the nine-slice regions.
+         * @param texture Image resource id, or INVALID_ID to draw like the classic style.
+         * @param width Width of the texture in texels.
+         * @param height Height of the texture in texels.
+         */
+        void setSkin(unique_id texture, float width, float height);
+
+        /**
+         * Returns the skin texture, or INVALID_ID.
+         */
+        auto getSkin() const { return skinTexture; }
+
+    protected:
+        void init() override;
+
+    private:
+        // Current theme, owned by the base class
+        const Theme* pixmapTheme{nullptr};
+        unique_id skinTexture{INVALID_ID};
+        float skinWidth{0};
+        float skinHeight{0};
+        // Logs once that the draw sink can't draw the skin
+        mutable std::once_flag regionsWarning;
+
+        // Adapts a typed drawing method to the Style::TypeHooks::Draw signature
+        template<typename T, void (StylePixmap::*method)(const T &, const StyleClassicResource &, DrawSink &) const>
+        static void drawHook(const Style &style, const Widget &widget, const UIResource &resources, DrawSink &renderer) {
+            (static_cast<const StylePixmap &>(style).*method)(
+                static_cast<const T &>(widget),
+                static_cast<const StyleClassicResource &>(resources),
+                renderer);
+        }
+
+        // Draws a region, returns false if the region can't be drawn
+        bool drawSlice(const Widget &, const StyleClassicResource &, DrawSink &, Slice slice) const;
+
+        void drawPanel(const Panel &, const StyleClassicResource &, DrawSink &) const;
+
+        void drawBox(const Widget &, const StyleClassicResource &, DrawSink &) const;
+
+        void drawButton(const Button &, const StyleClassicResource &, DrawSink &) const;
+
+        void drawToggleButton(const ToggleButton &, const StyleClassicResource &, DrawSink &) const;
+
+        void drawFrame(const Frame &, const StyleClassicResource &, DrawSink &) const;
+    };
+
+}
@@ -19,6 +19,7 @@ namespace lysa::ui {
     }
 
     void Text::setText(const std::string & text) {
+        if (this->text == text) { return; }
         this->text = text;
         if (window) {
             if (parent) {
@@ -49,6 +50,7 @@ namespace lysa::ui {
     }
 
     void Text::setTextColor(const float4 &c) {
+        if (all(textColor == c)) { return; }
         textColor = c;
         if (window) {
             refresh();
@@ -10,6 +10,7 @@ import std;
 import lysa.input;
 import lysa.log;
 import lysa.ui.alignment;
+import lysa.ui.trace;
 
 namespace lysa::ui {
 
@@ -33,6 +34,7 @@ namespace lysa::ui {
 
     void TextEdit::setText(const std::string& TEXT) {
         if (text == TEXT) return;
+        auto span = Trace::Scope{"TextEdit::setText"};
         if (text.empty()) {
             selStart = 0;
             startPos = 0;
@@ -47,7 +49,7 @@ namespace lysa::ui {
         textBox->setText(text.substr(startPos, nDispChar));
         box->refresh();
         refresh();
-        ctx.events.push({UIEvent::OnTextChange, UIEventTextChange{.text = text}, id});
+        emit(UIEvent::OnTextChange, UIEventTextChange{.text = text});
     }
 
     void TextEdit::setSelStart(const uint32 start) {
@@ -69,6 +71,7 @@ namespace lysa::ui {
     }
 
     bool TextEdit::eventKeyDown(const Key key) {
+        auto span = Trace::Scope{"TextEdit::eventKeyDown"};
         const auto consumed = Widget::eventKeyDown(key);
         if (isReadOnly()) { return key; }
 
@@ -110,7 +113,7 @@ namespace lysa::ui {
             if (!c.empty() || static_cast<int>(c[0]) < 12) {
                 setText(text.substr(0, selStart) + c +
                         text.substr(selStart, text.size() - selStart));
-                ctx.events.push({UIEvent::OnTextChange, UIEventTextChange{.text = text}, id});
+                emit(UIEvent::OnTextChange, UIEventTextChange{.text = text});
                 selStart++;
             }
             else {
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+module lysa.ui.texture_atlas;
+
+import lysa.exception;
+
+namespace lysa::ui {
+
+    TextureAtlas::TextureAtlas(const uint32 pageSize, const uint32 padding):
+        pageSize{pageSize},
+        padding{padding} {
+        assert([&]{ return pageSize > 2 * padding; }, "TextureAtlas: page size too small for the padding");
+    }
+
+    TextureAtlas::Region TextureAtlas::add(const lysa::Image& image) {
+        return add(image.id, static_cast<float>(image.getWidth()), static_cast<float>(image.getHeight()));
+    }
+
+    TextureAtlas::Region TextureAtlas::add(const unique_id source, const float width, const float height) {
+        if (const auto it = indices.find(source); it != indices.end()) {
+            return placements[it->second].region;
+        }
+        const auto size = static_cast<float>(pageSize);
+        const auto paddedWidth = width + 2.0f * padding;
+        const auto paddedHeight = height + 2.0f * padding;
+        if (paddedWidth > size || paddedHeight > size) {
+            throw Exception("Can't add image ", std::to_string(source), " to the texture atlas, larger than a page");
+        }
+
+        // Best fit : the shelf wasting the less height
+        Shelf* shelf{nullptr};
+        for (auto& candidate : shelves) {
+            if (candidate.height >= paddedHeight &&
+                candidate.x + paddedWidth <= size &&
+                (shelf == nullptr || candidate.height < shelf->height)) {
+                shelf = &candidate;
+            }
+        }
+        if (shelf == nullptr) {
+            auto page = std::size_t{0};
+            while (page < pageHeights.size() && pageHeights[page] + paddedHeight > size) { page += 1; }
+            if (page == pageHeights.size()) {
+                pageHeights.push_back(0.0f);
+                pageTextures.push_back(INVALID_ID);
+            }
+            shelves.push_back({static_cast<uint32>(page), pageHeights[page], paddedHeight, 0.0f});
+            pageHeights[page] += paddedHeight;
+            shelf = &shelves.back();
+        }
+
+        const auto x = shelf->x + padding;
+        const auto y = shelf->y + padding;
+        shelf->x += paddedWidth;
+        usedTexels += static_cast<double>(width) * height;
+        indices[source] = placements.size();
+        placements.push_back({
+            source,
+            {
+                .page = shelf->page,
+                .x = x,
+                .y = y,
+                .width = width,
+                .height = height,
+                .uv = float4{x / size, y / size, (x + width) / size, (y + height) / size},
+            }
+        });
+        return placements.back().region;
+    }
+
+    const TextureAtlas::Region* TextureAtlas::find(const unique_id source) const {
+        const auto it = indices.find(source);
+        return it == indices.end() ? nullptr : &placements[it->second].region;
+    }
+
+    void TextureAtlas::setPageTexture(const uint32 page, const unique_id texture) {
+        assert([&]{ return page < pageTextures.size(); }, "TextureAtlas: invalid page");
+        pageTextures[page] = texture;
+    }
+
+    unique_id TextureAtlas::getPageTexture(const uint32 page) const {
+        return page < pageTextures.size() ? pageTextures[page] : INVALID_ID;
+    }
+
+    float TextureAtlas::getEfficiency() const {
+        if (pageTextures.empty()) { return 0.0f; }
+        const auto size = static_cast<double>(pageSize);
+        return static_cast<float>(usedTexels / (size * size * pageTextures.size()));
+    }
+
+    void TextureAtlas::clear() {
+        placements.clear();
+        indices.clear();
+        shelves.clear();
+        pageHeights.clear();
+        pageTextures.clear();
+        usedTexels = 0;
+    }
+
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+export module lysa.ui.texture_atlas;
+
+import std;
+import lysa.math;
+import lysa.types;
+import lysa.resources.image;
+
+export namespace lysa::ui {
+
+    /**
+     * Packs small images into shared atlas pages.
+     *
+     * The atlas only computes the placements : the application copies each source image at its
+     * placement into the page images, see getPlacements(), then sets the texture of each page
+     * with setPageTexture(). Image widgets then reference a region with Image::setImage(atlas, source).
+     *
+     * Only the draw sinks supporting texture regions draw the regions with the page textures,
+     * the default RendererDrawSink does not and draws each image with its source texture.
+     *
+     * The regions are packed in shelves, adding the images from the tallest to the shortest gives
+     * the best packing efficiency.
+     */
+    class TextureAtlas {
+    public:
+        /**
+         * Region of a page.
+         */
+        struct Region {
+            uint32 page;    //! Page index
+            float x;        //! Position in the page, in texels
+            float y;        //! Position in the page, in texels
+            float width;    //! Size in texels
+            float height;   //! Size in texels
+            float4 uv;      //! Normalized region : left, top, right, bottom
+        };
+
+        /**
+         * Source image & its region.
+         */
+        struct Placement {
+            unique_id source;   //! Source image id
+            Region region;      //! Region of the source in the atlas
+        };
+
+        /**
+         * Creates an empty atlas.
+         * @param pageSize Width & height of the pages, in texels.
+         * @param padding Empty texels around each region, to avoid sampling the neighbors.
+         */
+        explicit TextureAtlas(uint32 pageSize = 1024, uint32 padding = 1);
+
+        /**
+         * Adds an image to the atlas, or returns its region if already added.
+         */
+        Region add(const lysa::Image& image);
+
+        /**
+         * Adds a source to the atlas, or returns its region if already added.
+         * @param source Id of the source image.
+         * @param width Width of the source image in texels.
+         * @param height Height of the source image in texels.
+         */
+        Region add(unique_id source, float width, float height);
+
+        /**
+         * Returns the region of a source image, or nullptr.
+         * The pointer is only valid until the next call to add() or clear().
+         */
+        const Region* find(unique_id source) const;
+
+        /**
+         * Returns the placements of all the sources, in the order they were added.
+         * The span is only valid until the next call to add() or clear().
+         */
+        std::span<const Placement> getPlacements() const { return placements; }
+
+        /**
+         * Sets the texture composed for a page.
+         * @param page Page index.
+         * @param texture Image resource id.
+         */
+        void setPageTexture(uint32 page, unique_id texture);
+
+        /**
+         * Returns the texture of a page, or INVALID_ID if not set.
+         */
+        unique_id getPageTexture(uint32 page) const;
+
+        /**
+         * Returns the number of pages.
+         */
+        auto getPageCount() const { return static_cast<uint32>(pageTextures.size()); }
+
+        /**
+         * Returns the size of the pages, in texels.
+         */
+        auto getPageSize() const { return pageSize; }
+
+        /**
+         * Returns the ratio of the texels of all the pages used by the regions, between 0.0 and 1.0.
+         */
+        float getEfficiency() const;
+
+        /**
+         * Removes all the sources and the pages.
+         */
+        void clear();
+
+    private:
+        struct Shelf {
+            uint32 page;
+            float y;
+            float height;
+            float x;
+        };
+
+        const uint32 pageSize;
+        const uint32 padding;
+        std::vector<Placement> placements;
+        std::unordered_map<unique_id, std::size_t> indices;
+        std::vector<Shelf> shelves;
+        // Height used by the shelves of each page
+        std::vector<float> pageHeights;
+        std::vector<unique_id> pageTextures;
+        double usedTexels{0};
+    };
+
+}
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+module;
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+module lysa.ui.theme_file;
+
+import lysa.exception;
+
+namespace lysa::ui {
+
+    std::shared_ptr<const ThemeFile> ThemeFile::load(const std::string& path) {
+        return std::shared_ptr<const ThemeFile>(new ThemeFile(path));
+    }
+
+#ifdef _WIN32
+    ThemeFile::ThemeFile(const std::string& path) {
+        const auto file = CreateFileW(
+            std::filesystem::path(path).c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL,
+            nullptr);
+        if (file == INVALID_HANDLE_VALUE) { throw Exception("Can't open theme file ", path); }
+        fileHandle = file;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize)) {
+            CloseHandle(file);
+            throw Exception("Can't read theme file ", path);
+        }
+        size = static_cast<std::size_t>(fileSize.QuadPart);
+        const auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) {
+            CloseHandle(file);
+            throw Exception("Can't map theme file ", path);
+        }
+        mappingHandle = mapping;
+        data = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (data == nullptr) {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            throw Exception("Can't map theme file ", path);
+        }
+        try {
+            validate(path);
+        } catch (...) {
+            UnmapViewOfFile(data);
+            CloseHandle(mapping);
+            CloseHandle(file);
+            throw;
+        }
+    }
+
+    ThemeFile::~ThemeFile() {
+        UnmapViewOfFile(data);
+        CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+    }
+#else
+    ThemeFile::ThemeFile(const std::string& path) {
+        const auto file = open(path.c_str(), O_RDONLY);
+        if (file < 0) { throw Exception("Can't open theme file ", path); }
+        struct stat fileStat{};
+        if (fstat(file, &fileStat) < 0) {
+            close(file);
+            throw Exception("Can't read theme file ", path);
+        }
+        size = static_cast<std::size_t>(fileStat.st_size);
+        const auto mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+        // The mapping stays valid after closing the file
+        close(file);
+        if (mapped == MAP_FAILED) { throw Exception("Can't map theme file ", path); }
+        data = static_cast<const std::byte*>(mapped);
+        try {
+            validate(path);
+        } catch (...) {
+            munmap(const_cast<std::byte*>(data), size);
+            throw;
+        }
+    }
+
+    ThemeFile::~ThemeFile() {
+        munmap(const_cast<std::byte*>(data), size);
+    }
+#endif
+
+    void ThemeFile::validate(const std::string& path) {
+        if (size < sizeof(Header)) { throw Exception("Invalid theme file ", path); }
+        header = reinterpret_cast<const Header*>(data);
+        if (header->magic != MAGIC || header->version != VERSION || header->size != size) {
+            throw Exception("Invalid theme file ", path);
+        }
+        const auto inside = [&](const std::uint64_t offset, const std::uint64_t length) {
+            return offset <= size && length <= size - offset;
+        };
+        if (!inside(header->fontsOffset, std::uint64_t{header->fontsCount} * sizeof(FontRef)) ||
+            !inside(header->nineSlicesOffset, std::uint64_t{header->nineSlicesCount} * sizeof(NineSlice)) ||
+            !inside(header->stringsOffset, header->stringsSize) ||
+            (header->fontsOffset % alignof(FontRef)) != 0 ||
+            (header->nineSlicesOffset % alignof(NineSlice)) != 0 ||
+            header->stringsSize == 0) {
+            throw Exception("Invalid theme file ", path);
+        }
+        strings = reinterpret_cast<const char*>(data + header->stringsOffset);
+        if (strings[0] != '\0' || strings[header->stringsSize - 1] != '\0') {
+            throw Exception("Invalid theme file ", path);
+        }
+        fonts = {reinterpret_cast<const FontRef*>(data + header->fontsOffset), header->fontsCount};
+        nineSlices = {reinterpret_cast<const NineSlice*>(data + header->nineSlicesOffset), header->nineSlicesCount};
+        const auto validString = [&](const uint32 offset) { return offset < header->stringsSize; };
+        if (!validString(header->skin)) { throw Exception("Invalid theme file ", path); }
+        for (const auto& font : fonts) {
+            if (!validString(font.name) || !validString(font.uri)) { throw Exception("Invalid theme file ", path); }
+        }
+        for (const auto& nineSlice : nineSlices) {
+            if (!validString(nineSlice.name)) { throw Exception("Invalid theme file ", path); }
+        }
+    }
+
+    const ThemeFile::NineSlice* ThemeFile::findNineSlice(const std::string_view name) const {
+        for (const auto& nineSlice : nineSlices) {
+            if (getString(nineSlice.name) == name) { return &nineSlice; }
+        }
+        return nullptr;
+    }
+
+    std::vector<char> ThemeFile::convert(const std::string& text) {
+        const auto trim = [](std::string_view str) {
+            while (!str.empty() && std::isspace(static_cast<unsigned char>(str.front()))) { str.remove_prefix(1); }
+            while (!str.empty() && std::isspace(static_cast<unsigned char>(str.back()))) { str.remove_suffix(1); }
+            return str;
+        };
+        const auto numbers = [&](const std::string_view line, const std::string_view value, const std::size_t min, const std::size_t max) {
+            auto result = std::vector<float>{};
+            for (const auto& part : value | std::views::split(',')) {
+                try {
+                    result.push_back(std::stof(std::string{trim(std::string_view{part})}));
+                } catch (const std::exception&) {
+                    throw Exception("Invalid number in theme line : ", std::string{line});
+                }
+            }
+            if (result.size() < min || result.size() > max) {
+                throw Exception("Invalid number of values in theme line : ", std::string{line});
+            }
+            return result;
+        };
+
+        auto header = Header{ .magic = MAGIC, .version = VERSION };
+        auto fontRefs = std::vector<FontRef>{};
+        auto regions = std::vector<NineSlice>{};
+        auto stringsBlock = std::string(1, '\0');
+        const auto addString = [&](const std::string_view str) {
+            if (str.empty()) { return uint32{0}; }
+            const auto offset = static_cast<uint32>(stringsBlock.size());
+            stringsBlock.append(str);
+            stringsBlock.push_back('\0');
+            return offset;
+        };
+
+        for (const auto& rawLine : std::string_view{text} | std::views::split('\n')) {
+            const auto line = trim(std::string_view{rawLine});
+            if (line.empty() || line.front() == '#') { continue; }
+            const auto equal = line.find('=');
+            if (equal == std::string_view::npos) {
+                throw Exception("Missing '=' in theme line : ", std::string{line});
+            }
+            const auto name = trim(line.substr(0, equal));
+            const auto value = trim(line.substr(equal + 1));
+            if (const auto color = std::ranges::find(COLOR_NAMES, name); color != COLOR_NAMES.end()) {
+                const auto index = std::distance(COLOR_NAMES.begin(), color);
+                const auto rgba = numbers(line, value, 3, 4);
+                std::ranges::copy(rgba, header.colors[index]);
+                if (rgba.size() == 3) { header.colors[index][3] = 1.0f; }
+                header.colorsMask |= 1u << index;
+            } else if (const auto metric = std::ranges::find(METRIC_NAMES, name); metric != METRIC_NAMES.end()) {
+                const auto index = std::distance(METRIC_NAMES.begin(), metric);
+                header.metrics[index] = numbers(line, value, 1, 1)[0];
+                header.metricsMask |= 1u << index;
+            } else if (name == "skin") {
+                header.skin = addString(value);
+            } else if (name.starts_with("font.")) {
+                const auto comma = value.find(',');
+                fontRefs.push_back({
+                    .name = addString(name.substr(5)),
+                    .uri = addString(trim(value.substr(0, comma))),
+                    .scale = comma == std::string_view::npos ? 1.0f : numbers(line, value.substr(comma + 1), 1, 1)[0],
+                });
+            } else if (name.starts_with("nine_slice.")) {
+                const auto v = numbers(line, value, 8, 8);
+                regions.push_back({
+                    .name = addString(name.substr(11)),
+                    .x = v[0], .y = v[1], .width = v[2], .height = v[3],
+                    .left = v[4], .top = v[5], .right = v[6], .bottom = v[7],
+                });
+            } else {
+                throw Exception("Unknown theme option : ", std::string{name});
+            }
+        }
+
+        header.fontsCount = static_cast<uint32>(fontRefs.size());
+        header.fontsOffset = sizeof(Header);
+        header.nineSlicesCount = static_cast<uint32>(regions.size());
+        header.nineSlicesOffset = header.fontsOffset + header.fontsCount * sizeof(FontRef);
+        header.stringsOffset = header.nineSlicesOffset + header.nineSlicesCount * sizeof(NineSlice);
+        header.stringsSize = static_cast<uint32>(stringsBlock.size());
+        header.size = header.stringsOffset + header.stringsSize;
+
+        auto result = std::vector<char>(header.size);
+        std::memcpy(result.data(), &header, sizeof(Header));
+        std::memcpy(result.data() + header.fontsOffset, fontRefs.data(), fontRefs.size() * sizeof(FontRef));
+        std::memcpy(result.data() + header.nineSlicesOffset, regions.data(), regions.size() * sizeof(NineSlice));
+        std::memcpy(result.data() + header.stringsOffset, stringsBlock.data(), stringsBlock.size());
+        return result;
+    }
+
+    void ThemeFile::convert(const std::string& textPath, const std::string& binaryPath) {
+        auto input = std::ifstream(textPath);
+        if (!input) { throw Exception("Can't open theme file ", textPath); }
+        const auto binary = convert(std::string{std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()});
+        auto output = std::ofstream(binaryPath, std::ios::binary);
+        if (!output) { throw Exception("Can't create theme file ", binaryPath); }
+        output.write(binary.data(), static_cast<std::streamsize>(binary.size()));
+    }
+
+}
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+export module lysa.ui.theme_file;
+
+import std;
+import lysa.math;
+import lysa.types;
+
+export namespace lysa::ui {
+
+    /**
+     * Compact binary theme, memory-mapped and used in place without parsing.
+     *
+     * The file starts with a Header holding the colors & metrics, followed by the font references,
+     * the nine-slice regions and a block of null-terminated strings. All the offsets are in bytes,
+     * strings offsets are relative to the strings block, and the offset 0 is the empty string.
+     *
+     * Binary themes are produced by convert() from a text file of `name = value` lines, using the
+     * style option names for colors & metrics, plus :
+     * - `skin = uri` : the skin texture used by the nine-slice regions,
+     * - `font.<name> = uri,scale` : a font reference,
+     * - `nine_slice.<name> = x,y,width,height,left,top,right,bottom` : a region of the skin texture
+     *   and the size of its borders, in texels.
+     * Empty lines and lines starting with `#` are ignored.
+     */
+    class ThemeFile {
+    public:
+        /**
+         * Colors slots.
+         */
+        enum Color : uint32 {
+            COLOR_FOCUS,            //! `color_focus`
+            COLOR_SHADOW_DARK,      //! `color_shadow_dark`
+            COLOR_SHADOW_BRIGHT,    //! `color_shadow_bright`
+            COLOR_FOREGROUND_UP,    //! `color_foreground_up`
+            COLOR_FOREGROUND_DOWN,  //! `color_foreground_down`
+            COLOR_COUNT
+        };
+
+        /**
+         * Metrics slots.
+         */
+        enum Metric : uint32 {
+            METRIC_BOX_BORDER,      //! `box_border`
+            METRIC_FRAME_BORDER,    //! `frame_border`
+            METRIC_COUNT
+        };
+
+        /**
+         * File header.
+         */
+        struct Header {
+            uint32 magic;                    //! MAGIC
+            uint32 version;                  //! VERSION
+            uint32 size;                     //! Total size of the file
+            uint32 colorsMask;               //! One bit per defined color slot
+            uint32 metricsMask;              //! One bit per defined metric slot
+            float colors[COLOR_COUNT][4];    //! RGBA colors
+            float metrics[METRIC_COUNT];     //! Metrics
+            uint32 skin;                     //! Skin texture URI
+            uint32 fontsCount;               //! Number of FontRef
+            uint32 fontsOffset;              //! Offset of the first FontRef
+            uint32 nineSlicesCount;          //! Number of NineSlice
+            uint32 nineSlicesOffset;         //! Offset of the first NineSlice
+            uint32 stringsOffset;            //! Offset of the strings block
+            uint32 stringsSize;              //! Size of the strings block
+        };
+
+        /**
+         * Font reference.
+         */
+        struct FontRef {
+            uint32 name;    //! Font name
+            uint32 uri;     //! Font file URI
+            float scale;    //! Font scale
+        };
+
+        /**
+         * Nine-slice region of the skin texture.
+         */
+        struct NineSlice {
+            uint32 name;    //! Region name
+            float x;        //! Region position in the skin texture
+            float y;        //! Region position in the skin texture
+            float width;    //! Region size in the skin texture
+            float height;   //! Region size in the skin texture
+            float left;     //! Left border size
+            float top;      //! Top border size
+            float right;    //! Right border size
+            float bottom;   //! Bottom border size
+        };
+
+        static constexpr uint32 MAGIC{0x5449554c}; //! "LUIT"
+        static constexpr uint32 VERSION{1};
+
+        /**
+         * Style option names of the color slots.
+         */
+        static constexpr std::array<std::string_view, COLOR_COUNT> COLOR_NAMES{
+            "color_focus",
+            "color_shadow_dark",
+            "color_shadow_bright",
+            "color_foreground_up",
+            "color_foreground_down",
+        };
+
+        /**
+         * Style option names of the metric slots.
+         */
+        static constexpr std::array<std::string_view, METRIC_COUNT> METRIC_NAMES{
+            "box_border",
+            "frame_border",
+        };
+
+        /**
+         * Memory-maps a binary theme file.
+         * @param path Path of the binary theme file.
+         */
+        static std::shared_ptr<const ThemeFile> load(const std::string& path);
+
+        /**
+         * Converts a text theme into a binary theme.
+         * @param text Content of the text theme.
+         * @return Content of the binary theme.
+         */
+        static std::vector<char> convert(const std::string& text);
+
+        /**
+         * Converts a text theme file into a binary theme file.
+         * @param textPath Path of the text theme file to read.
+         * @param binaryPath Path of the binary theme file to write.
+         */
+        static void convert(const std::string& textPath, const std::string& binaryPath);
+
+        ~ThemeFile();
+
+        ThemeFile(const ThemeFile&) = delete;
+
+        ThemeFile& operator=(const ThemeFile&) = delete;
+
+        /**
+         * Returns true if the theme defines a color.
+         */
+        bool hasColor(const Color color) const { return header->colorsMask & (1u << color); }
+
+        /**
+         * Returns a color, only meaningful if hasColor() is true.
+         */
+        float4 getColor(const Color color) const {
+            const auto& c = header->colors[color];
+            return float4{c[0], c[1], c[2], c[3]};
+        }
+
+        /**
+         * Returns true if the theme defines a metric.
+         */
+        bool hasMetric(const Metric metric) const { return header->metricsMask & (1u << metric); }
+
+        /**
+         * Returns a metric, only meaningful if hasMetric() is true.
+         */
+        float getMetric(const Metric metric) const { return header->metrics[metric]; }
+
+        /**
+         * Returns the skin texture URI, empty if none.
+         */
+        std::string_view getSkin() const { return getString(header->skin); }
+
+        /**
+         * Returns the font references.
+         */
+        std::span<const FontRef> getFonts() const { return fonts; }
+
+        /**
+         * Returns the nine-slice regions.
+         */
+        std::span<const NineSlice> getNineSlices() const { return nineSlices; }
+
+        /**
+         * Returns a nine-slice region by name, or nullptr.
+         */
+        const NineSlice* findNineSlice(std::string_view name) const;
+
+        /**
+         * Returns a string of the strings block.
+         */
+        std::string_view getString(const uint32 offset) const { return {strings + offset}; }
+
+    private:
+        const std::byte* data{nullptr};
+        std::size_t size{0};
+        void* fileHandle{nullptr};
+        void* mappingHandle{nullptr};
+        const Header* header{nullptr};
+        std::span<const FontRef> fonts;
+        std::span<const NineSlice> nineSlices;
+        const char* strings{nullptr};
+
+        explicit ThemeFile(const std::string& path);
+
+        void validate(const std::string& path);
+    };
+
+}
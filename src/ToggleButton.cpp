@@ -16,10 +16,16 @@ namespace lysa::ui {
         allowFocus = true;
     }
 
+    void ToggleButton::setState(const State newState) {
+        setPushed(newState == CHECK);
+        CheckWidget::setState(newState);
+    }
+
     bool ToggleButton::eventMouseUp(const MouseButton button, const float x, const float y)  {
         CheckWidget::eventMouseUp(button, x, y);
+        setPushed(getState() == CHECK);
         if (getRect().contains(x, y)) {
-            ctx.events.push({UIEvent::OnClick, UIEventClick{}, id});
+            emit(UIEvent::OnClick, UIEventClick{});
             return true;
         }
         return false;
@@ -23,6 +23,11 @@ export namespace lysa::ui {
          */
         ToggleButton(Context& ctx);
 
+        /**
+         * Changes the state of the widget, a checked toggle button stays pushed.
+         */
+        void setState(State newState) override;
+
     protected:
         bool eventMouseUp(MouseButton button, float x, float y) override;
     };
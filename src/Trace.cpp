@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+module lysa.ui.trace;
+
+import lysa.exception;
+
+namespace lysa::ui {
+
+    namespace {
+
+        struct Span {
+            const char* name;
+            std::int64_t start;
+            std::int64_t end;
+        };
+
+        // Written only by its thread, read by the export
+        struct Buffer {
+            uint32 thread;
+            std::atomic<std::uint64_t> count{0};
+            std::array<Span, Trace::BUFFER_SIZE> spans;
+        };
+
+        std::mutex buffersMutex;
+        std::vector<std::unique_ptr<Buffer>> buffers;
+        thread_local Buffer* threadBuffer{nullptr};
+
+    }
+
+    void Trace::setEnabled(const bool enable) {
+        enabled.store(enable && ENABLED, std::memory_order_relaxed);
+    }
+
+    void Trace::record(const char* name, const std::int64_t start, const std::int64_t end) {
+        if (threadBuffer == nullptr) {
+            // Once per thread, buffers are kept after the end of their thread for the export
+            auto lock = std::lock_guard(buffersMutex);
+            buffers.push_back(std::make_unique<Buffer>());
+            threadBuffer = buffers.back().get();
+            threadBuffer->thread = static_cast<uint32>(buffers.size());
+        }
+        const auto index = threadBuffer->count.load(std::memory_order_relaxed);
+        threadBuffer->spans[index % BUFFER_SIZE] = {name, start, end};
+        threadBuffer->count.store(index + 1, std::memory_order_release);
+    }
+
+    void Trace::clear() {
+        auto lock = std::lock_guard(buffersMutex);
+        for (const auto& buffer : buffers) {
+            buffer->count.store(0, std::memory_order_release);
+        }
+    }
+
+    std::string Trace::toJson() {
+        auto lock = std::lock_guard(buffersMutex);
+        auto origin = std::numeric_limits<std::int64_t>::max();
+        for (const auto& buffer : buffers) {
+            const auto count = buffer->count.load(std::memory_order_acquire);
+            const auto first = count > BUFFER_SIZE ? count - BUFFER_SIZE : 0;
+            for (auto index = first; index < count; index++) {
+                origin = std::min(origin, buffer->spans[index % BUFFER_SIZE].start);
+            }
+        }
+
+        auto result = std::string{"{\"traceEvents\":["};
+        auto separator = "";
+        for (const auto& buffer : buffers) {
+            const auto count = buffer->count.load(std::memory_order_acquire);
+            const auto first = count > BUFFER_SIZE ? count - BUFFER_SIZE : 0;
+            for (auto index = first; index < count; index++) {
+                const auto& span = buffer->spans[index % BUFFER_SIZE];
+                // Chrome trace timestamps are in microseconds
+                result += std::format(
+                    "{}\n{{\"name\":\"{}\",\"cat\":\"ui\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":{}}}",
+                    separator,
+                    span.name,
+                    static_cast<double>(span.start - origin) / 1000.0,
+                    static_cast<double>(span.end - span.start) / 1000.0,
+                    buffer->thread);
+                separator = ",";
+            }
+        }
+        result += "\n],\"displayTimeUnit\":\"ms\"}\n";
+        return result;
+    }
+
+    void Trace::save(const std::string& path) {
+        auto file = std::ofstream(path, std::ios::binary);
+        if (!file) { throw Exception("Can't create trace file ", path); }
+        file << toJson();
+    }
+
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+export module lysa.ui.trace;
+
+import std;
+import lysa.types;
+
+export namespace lysa::ui {
+
+    /**
+     * Timeline of the UI work, exported in the Chrome trace JSON format
+     * (chrome://tracing, https://ui.perfetto.dev).
+     *
+     * Each thread writes its spans into its own ring buffer without any lock, the oldest spans
+     * being overwritten when a buffer is full. Spans are recorded only after setEnabled(true),
+     * and the whole facility is compiled only when LYSA_UI_TRACE is defined (CMake variable of the same name).
+     */
+    class Trace {
+    public:
+#ifdef LYSA_UI_TRACE
+        static constexpr bool ENABLED{true};
+#else
+        static constexpr bool ENABLED{false};
+#endif
+        //! Number of spans kept for each thread
+        static constexpr uint32 BUFFER_SIZE{65536};
+
+        /**
+         * Records a span covering a C++ scope.
+         */
+        class Scope {
+        public:
+            /**
+             * Starts the span.
+             * @param name Span name, must be a string literal.
+             */
+            explicit Scope(const char* name) {
+                if constexpr (ENABLED) {
+                    if (isEnabled()) {
+                        this->name = name;
+                        start = now();
+                    }
+                }
+            }
+
+            ~Scope() {
+                if constexpr (ENABLED) {
+                    if (name) { record(name, start, now()); }
+                }
+            }
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            const char* name{nullptr};
+            std::int64_t start{0};
+        };
+
+        /**
+         * Returns true if the spans are recorded.
+         */
+        static bool isEnabled() {
+            if constexpr (ENABLED) {
+                return enabled.load(std::memory_order_relaxed);
+            }
+            return false;
+        }
+
+        /**
+         * Starts or stops recording the spans.
+         */
+        static void setEnabled(bool enable);
+
+        /**
+         * Removes all the recorded spans. Call it when the tracing is disabled.
+         */
+        static void clear();
+
+        /**
+         * Returns the recorded spans of all the threads as a Chrome trace JSON document.
+         *
+         * Disable the tracing before exporting, otherwise the spans written during the export can be missing or torn.
+         */
+        static std::string toJson();
+
+        /**
+         * Writes the Chrome trace JSON document into a local file.
+         */
+        static void save(const std::string& path);
+
+    private:
+        static inline std::atomic<bool> enabled{false};
+
+        static std::int64_t now() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        static void record(const char* name, std::int64_t start, std::int64_t end);
+    };
+
+}
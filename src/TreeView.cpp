@@ -7,6 +7,7 @@
 module lysa.ui.tree_view;
 
 import lysa.ui.alignment;
+import lysa.ui.trace;
 
 namespace lysa::ui {
 
@@ -27,11 +28,13 @@ namespace lysa::ui {
     }
 
     void TreeView::removeAllItems() {
+        auto span = Trace::Scope{"TreeView::removeAllItems"};
         box->removeAll();
         items.clear();
     }
 
     std::shared_ptr<TreeView::Item>& TreeView::addItem(std::shared_ptr<Widget> item) {
+        auto span = Trace::Scope{"TreeView::addItem"};
         items.push_back(std::make_shared<Item>(ctx, item));
         auto& newWidget = items.back();
         box->add(newWidget, Alignment::TOPLEFT);
@@ -44,6 +47,7 @@ namespace lysa::ui {
     }
 
     std::shared_ptr<TreeView::Item>& TreeView::addItem(const std::shared_ptr<Item>& parent, std::shared_ptr<Widget> item) const {
+        auto span = Trace::Scope{"TreeView::addItem"};
         parent->children.push_back(std::make_shared<Item>(ctx, item));
         auto& newWidget = parent->children.back();
         newWidget->level = parent->level + 1;
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+module lysa.ui.tweens;
+
+namespace lysa::ui {
+
+    Tweens::Handle Tweens::transparency(const std::shared_ptr<Widget>& widget, const float alpha, const float duration,
+                                        const Easing easing, Callback onComplete) {
+        const auto from = widget->getTransparency();
+        return add(widget, Property::TRANSPARENCY, from, 0.0f, alpha, 0.0f, duration, easing, std::move(onComplete));
+    }
+
+    Tweens::Handle Tweens::pos(const std::shared_ptr<Widget>& widget, const float x, const float y, const float duration,
+                               const Easing easing, Callback onComplete) {
+        const auto& rect = widget->getRect();
+        return add(widget, Property::POS, rect.x, rect.y, x, y, duration, easing, std::move(onComplete));
+    }
+
+    Tweens::Handle Tweens::size(const std::shared_ptr<Widget>& widget, const float width, const float height, const float duration,
+                                const Easing easing, Callback onComplete) {
+        const auto& rect = widget->getRect();
+        return add(widget, Property::SIZE, rect.width, rect.height, width, height, duration, easing, std::move(onComplete));
+    }
+
+    Tweens::Handle Tweens::value(const std::shared_ptr<ValueSelect>& widget, const float value, const float duration,
+                                 const Easing easing, Callback onComplete) {
+        const auto from = widget->getValue();
+        return add(widget, Property::VALUE, from, 0.0f, value, 0.0f, duration, easing, std::move(onComplete));
+    }
+
+    Tweens::Handle Tweens::add(const std::shared_ptr<Widget>& widget, const Property property,
+                               const float fromX, const float fromY, const float toX, const float toY,
+                               const float duration, const Easing easing, Callback&& onComplete) {
+        for (auto index = std::size_t{0}; index < handles.size(); index++) {
+            if (properties[index] == property && !widgets[index].owner_before(widget) && !widget.owner_before(widgets[index])) {
+                removeAt(index);
+                break;
+            }
+        }
+        handles.push_back(nextHandle);
+        widgets.push_back(widget);
+        properties.push_back(property);
+        easings.push_back(easing);
+        elapsed.push_back(0.0f);
+        durations.push_back(std::max(duration, 0.0f));
+        progress.push_back(0.0f);
+        this->fromX.push_back(fromX);
+        this->fromY.push_back(fromY);
+        this->toX.push_back(toX);
+        this->toY.push_back(toY);
+        callbacks.push_back(std::move(onComplete));
+        return nextHandle++;
+    }
+
+    void Tweens::removeAt(const std::size_t index) {
+        const auto last = handles.size() - 1;
+        if (index != last) {
+            handles[index] = handles[last];
+            widgets[index] = std::move(widgets[last]);
+            properties[index] = properties[last];
+            easings[index] = easings[last];
+            elapsed[index] = elapsed[last];
+            durations[index] = durations[last];
+            progress[index] = progress[last];
+            fromX[index] = fromX[last];
+            fromY[index] = fromY[last];
+            toX[index] = toX[last];
+            toY[index] = toY[last];
+            callbacks[index] = std::move(callbacks[last]);
+        }
+        handles.pop_back();
+        widgets.pop_back();
+        properties.pop_back();
+        easings.pop_back();
+        elapsed.pop_back();
+        durations.pop_back();
+        progress.pop_back();
+        fromX.pop_back();
+        fromY.pop_back();
+        toX.pop_back();
+        toY.pop_back();
+        callbacks.pop_back();
+    }
+
+    void Tweens::cancel(const Handle handle) {
+        const auto it = std::ranges::find(handles, handle);
+        if (it != handles.end()) {
+            removeAt(std::distance(handles.begin(), it));
+        }
+    }
+
+    void Tweens::cancel(const Widget& widget) {
+        for (auto index = std::size_t{0}; index < handles.size();) {
+            const auto target = widgets[index].lock();
+            if (target.get() == &widget) {
+                removeAt(index);
+            } else {
+                index += 1;
+            }
+        }
+    }
+
+    float Tweens::ease(const Easing easing, const float t) {
+        switch (easing) {
+        case Easing::LINEAR:
+            return t;
+        case Easing::QUAD_IN:
+            return t * t;
+        case Easing::QUAD_OUT:
+            return t * (2.0f - t);
+        case Easing::QUAD_IN_OUT:
+            return t < 0.5f ? 2.0f * t * t : -1.0f + (4.0f - 2.0f * t) * t;
+        case Easing::CUBIC_IN:
+            return t * t * t;
+        case Easing::CUBIC_OUT: {
+            const auto u = t - 1.0f;
+            return u * u * u + 1.0f;
+        }
+        case Easing::CUBIC_IN_OUT: {
+            if (t < 0.5f) { return 4.0f * t * t * t; }
+            const auto u = 2.0f * t - 2.0f;
+            return 0.5f * u * u * u + 1.0f;
+        }
+        case Easing::SINE_IN_OUT:
+            return 0.5f * (1.0f - std::cos(std::numbers::pi_v<float> * t));
+        case Easing::BACK_OUT: {
+            constexpr auto s = 1.70158f;
+            const auto u = t - 1.0f;
+            return u * u * ((s + 1.0f) * u + s) + 1.0f;
+        }
+        }
+        return t;
+    }
+
+    void Tweens::update(const float delta) {
+        const auto count = handles.size();
+        if (count == 0) { return; }
+
+        // Progress of all the tweens in one pass over the contiguous arrays
+        for (auto index = std::size_t{0}; index < count; index++) {
+            elapsed[index] += delta;
+            progress[index] = durations[index] > 0.0f ? std::min(elapsed[index] / durations[index], 1.0f) : 1.0f;
+        }
+
+        // Sets the eased values, the widgets are laid out & refreshed by the caller
+        completed.clear();
+        for (auto index = std::size_t{0}; index < handles.size();) {
+            const auto widget = widgets[index].lock();
+            if (!widget) {
+                removeAt(index);
+                continue;
+            }
+            const auto t = ease(easings[index], progress[index]);
+            const auto x = std::lerp(fromX[index], toX[index], t);
+            const auto y = std::lerp(fromY[index], toY[index], t);
+            switch (properties[index]) {
+            case Property::TRANSPARENCY:
+                widget->setTransparency(x);
+                break;
+            case Property::POS:
+                widget->setPos(x, y);
+                break;
+            case Property::SIZE:
+                widget->setSize(x, y);
+                break;
+            case Property::VALUE:
+                static_cast<ValueSelect&>(*widget).setValue(x);
+                break;
+            }
+            if (progress[index] >= 1.0f) {
+                if (callbacks[index]) { completed.push_back(std::move(callbacks[index])); }
+                removeAt(index);
+                continue;
+            }
+            index += 1;
+        }
+
+        // Called last, the callbacks can start new tweens
+        for (auto& callback : completed) {
+            callback();
+        }
+        completed.clear();
+    }
+
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+export module lysa.ui.tweens;
+
+import std;
+import lysa.types;
+import lysa.ui.value_select;
+import lysa.ui.widget;
+
+export namespace lysa::ui {
+
+    /**
+     * Easing curves of the tweens
+     */
+    enum class Easing : uint8 {
+        LINEAR,
+        QUAD_IN,
+        QUAD_OUT,
+        QUAD_IN_OUT,
+        CUBIC_IN,
+        CUBIC_OUT,
+        CUBIC_IN_OUT,
+        SINE_IN_OUT,
+        BACK_OUT,
+    };
+
+    /**
+     * Animates widgets properties, see WindowManager::getTweens().
+     *
+     * The active tweens are updated once per frame at the start of WindowManager::drawFrame(),
+     * before the layout, and all the changes of a frame are laid out & refreshed once per Window.
+     * Starting a tween on a property already animated replaces the previous tween, which
+     * completion callback is not called.
+     * ```
+     * ui.getTweens().transparency(panel, 0.0f, 0.25f, Easing::QUAD_OUT, [&]{ panel->hide(); });
+     * ```
+     */
+    class Tweens {
+    public:
+        /**
+         * Tween identifier, to cancel a tween.
+         */
+        using Handle = uint32;
+
+        /**
+         * Function called when a tween reaches its end value.
+         */
+        using Callback = std::function<void()>;
+
+        /**
+         * Animates Widget::setTransparency()
+         * @param widget The animated widget, the tween is removed if the widget is destroyed.
+         * @param alpha The end value.
+         * @param duration Duration in seconds.
+         * @param easing Easing curve.
+         * @param onComplete Called after the end value is set.
+         */
+        Handle transparency(const std::shared_ptr<Widget>& widget, float alpha, float duration,
+                            Easing easing = Easing::LINEAR, Callback onComplete = nullptr);
+
+        /**
+         * Animates Widget::setPos()
+         */
+        Handle pos(const std::shared_ptr<Widget>& widget, float x, float y, float duration,
+                   Easing easing = Easing::LINEAR, Callback onComplete = nullptr);
+
+        /**
+         * Animates Widget::setSize()
+         */
+        Handle size(const std::shared_ptr<Widget>& widget, float width, float height, float duration,
+                    Easing easing = Easing::LINEAR, Callback onComplete = nullptr);
+
+        /**
+         * Animates ValueSelect::setValue(), for smooth scrolling
+         */
+        Handle value(const std::shared_ptr<ValueSelect>& widget, float value, float duration,
+                     Easing easing = Easing::LINEAR, Callback onComplete = nullptr);
+
+        /**
+         * Stops a tween, leaving the property at its current value. The completion callback is not called.
+         */
+        void cancel(Handle handle);
+
+        /**
+         * Stops all the tweens of a widget.
+         */
+        void cancel(const Widget& widget);
+
+        /**
+         * Advances all the tweens, sets the widgets properties & calls the completion callbacks.
+         * @param delta Elapsed time in seconds since the last update.
+         */
+        void update(float delta);
+
+        /**
+         * Returns the number of active tweens.
+         */
+        auto getSize() const { return handles.size(); }
+
+        /**
+         * Returns the eased value of a progress between 0.0 and 1.0
+         */
+        static float ease(Easing easing, float t);
+
+    private:
+        enum class Property : uint8 { TRANSPARENCY, POS, SIZE, VALUE };
+
+        // One entry per tween in each array, removed by swapping with the last
+        std::vector<Handle> handles;
+        std::vector<std::weak_ptr<Widget>> widgets;
+        std::vector<Property> properties;
+        std::vector<Easing> easings;
+        std::vector<float> elapsed;
+        std::vector<float> durations;
+        std::vector<float> progress;
+        std::vector<float> fromX;
+        std::vector<float> fromY;
+        std::vector<float> toX;
+        std::vector<float> toY;
+        std::vector<Callback> callbacks;
+        // Callbacks of the tweens completed during update(), called after all the widgets are set
+        std::vector<Callback> completed;
+        Handle nextHandle{1};
+
+        Handle add(const std::shared_ptr<Widget>& widget, Property property,
+                   float fromX, float fromY, float toX, float toY,
+                   float duration, Easing easing, Callback&& onComplete);
+
+        void removeAt(std::size_t index);
+    };
+
+}
@@ -7,24 +7,39 @@
 export module lysa.ui;
 
 export import lysa.ui.alignment;
+export import lysa.ui.bindings;
 export import lysa.ui.box;
 export import lysa.ui.button;
 export import lysa.ui.check_widget;
+export import lysa.ui.command_queue;
+export import lysa.ui.draw_recorder;
+export import lysa.ui.draw_sink;
 export import lysa.ui.event;
 export import lysa.ui.frame;
+export import lysa.ui.frame_stats;
 export import lysa.ui.image;
+export import lysa.ui.layout_file;
 export import lysa.ui.line;
 export import lysa.ui.panel;
+export import lysa.ui.refresh_tracer;
+export import lysa.ui.resource_descriptor;
 export import lysa.ui.uiresource;
 export import lysa.ui.scroll_bar;
 export import lysa.ui.style;
 export import lysa.ui.style_classic;
 export import lysa.ui.style_classic_resource;
+export import lysa.ui.style_pixmap;
 export import lysa.ui.text;
 export import lysa.ui.text_edit;
+export import lysa.ui.texture_atlas;
+export import lysa.ui.theme_file;
 export import lysa.ui.tree_view;
 export import lysa.ui.toggle_button;
+export import lysa.ui.trace;
+export import lysa.ui.tweens;
 export import lysa.ui.value_select;
 export import lysa.ui.widget;
+export import lysa.ui.widget_index;
 export import lysa.ui.window;
 export import lysa.ui.window_manager;
+export import lysa.ui.window_snapshot;
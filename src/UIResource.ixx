@@ -13,6 +13,9 @@ export namespace lysa::ui {
     /**
      * @class UIResource
      * @brief Base class for style resources descriptions.
+     *
+     * Resources are immutable and shared between all the widgets using the same
+     * description string, per-widget state belongs to the widget.
      */
     class UIResource {
     public:
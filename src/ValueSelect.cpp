@@ -35,7 +35,7 @@ namespace lysa::ui {
         resizeChildren();
         eventRangeChange();
         refresh();
-        ctx.events.push({UIEvent::OnRangeChange, UIEventRange{.min = min, .max = max, .value = value}, id});
+        emit(UIEvent::OnRangeChange, UIEventRange{.min = min, .max = max, .value = value});
     }
 
     void ValueSelect::setMax(const float max) {
@@ -47,7 +47,7 @@ namespace lysa::ui {
         }
         resizeChildren();
         eventRangeChange();
-        ctx.events.push({UIEvent::OnRangeChange, UIEventRange{.min = min, .max = max, .value = value}, id});
+        emit(UIEvent::OnRangeChange, UIEventRange{.min = min, .max = max, .value = value});
     }
 
     void ValueSelect::setValue(const float value) {
@@ -65,7 +65,7 @@ namespace lysa::ui {
         if (parent) {
             parent->refresh();
         }
-        ctx.events.push({UIEvent::OnValueChange, UIEventValue{.value = this->value, .previous = prev}, id});
+        emit(UIEvent::OnValueChange, UIEventValue{.value = this->value, .previous = prev});
     }
 
     void ValueSelect::setStep(const float step) {
@@ -82,11 +82,11 @@ namespace lysa::ui {
     }
 
     void ValueSelect::eventRangeChange() {
-        ctx.events.push({UIEvent::OnRangeChange, UIEventRange{.min = min, .max = max, .value = value}, id});
+        emit(UIEvent::OnRangeChange, UIEventRange{.min = min, .max = max, .value = value});
     }
 
     void ValueSelect::eventValueChange(const float prev) {
-        ctx.events.push({UIEvent::OnValueChange, UIEventRange{.min = min, .max = max, .value = value}, id});
+        emit(UIEvent::OnValueChange, UIEventRange{.min = min, .max = max, .value = value});
     }
 
 }
@@ -8,27 +8,38 @@ module lysa.ui.widget;
 
 import lysa.log;
 import lysa.rect;
-import lysa.renderers.vector_2d;
+import lysa.ui.draw_sink;
 import lysa.resources.font;
 import lysa.ui.event;
 import lysa.ui.uiresource;
 import lysa.ui.style;
+import lysa.ui.trace;
 import lysa.ui.window;
 
 namespace lysa::ui {
 
     Widget::Widget(Context& ctx, const Type T) : ctx(ctx), type{T} {}
 
-    void Widget::_draw(Vector2DRenderer &R) const {
+    void Widget::_draw(DrawSink &R) const {
         if (!isVisible()) {
             return;
         }
-        const auto *s = static_cast<Style *>(style);
-        s->draw(*this, *resource, R, true);
+        if constexpr (FrameStats::ENABLED) {
+            if (const auto stats = getFrameStats()) { stats->count(&FrameStats::widgetsDrawn); }
+        }
+        const auto *s = static_cast<const Style *>(style);
+        const auto *h = static_cast<const Style::TypeHooks *>(hooks);
+        if (h->drawBefore) {
+            auto span = Trace::Scope{"Style::draw"};
+            h->drawBefore(*s, *this, *resource, R);
+        }
         for (auto &child : children) {
             child->_draw(R);
         }
-        s->draw(*this, *resource, R, false);
+        if (h->drawAfter) {
+            auto span = Trace::Scope{"Style::draw"};
+            h->drawAfter(*s, *this, *resource, R);
+        }
     }
 
     bool Widget::isVisible() const {
@@ -45,6 +56,7 @@ namespace lysa::ui {
         if (visible == S)
             return;
         visible = S;
+        invalidateFocusChain();
         if (visible) {
             eventShow();
         } else {
@@ -56,6 +68,7 @@ namespace lysa::ui {
         if (enabled == isEnabled)
             return;
         enabled = isEnabled;
+        invalidateFocusChain();
         if (enabled) {
             eventEnable();
         } else {
@@ -64,7 +77,8 @@ namespace lysa::ui {
     }
 
     void Widget::setPos(const float x, const float y) {
-        if ((x == rect.x) && (y == rect.y)) { return; }
+        const auto& current = getRect();
+        if ((x == current.x) && (y == current.y)) { return; }
         eventMove(x, y);
     }
 
@@ -91,38 +105,18 @@ namespace lysa::ui {
         eventResize();
     }
 
-    void Widget::setResource(std::shared_ptr<UIResource> R) {
+    void Widget::setResource(std::shared_ptr<const UIResource> R) {
         resource = std::move(R);
         refresh();
     }
 
     std::shared_ptr<Widget> Widget::setNextFocus() {
-        if (focused) {
-            setFocus(false);
-        } else {
-            auto r = setFocus();
-            if (r) {
-                return r;
-            }
-        }
+        if (!window) { return nullptr; }
+        return static_cast<Window *>(window)->_focusStep(this, 1);
+    }
 
-        if (!parent)
-            return nullptr;
-        /* uint32_t idx;
-         Widget* p = parent;
-         Widget* s = this;
-
-         auto it = children.begin();
-         do {
-             list = p->children;
-             if (!((idx = list.IndexOf(*s)) == p->children.Count())) { break; }
-             s = p;
-             p = p->parent;
-             if (!p) return s->SetFocus();
-         } while (true);
-         return list[idx+1].SetNextFocus();*/
-        throw Exception("Not implemented");
-        return nullptr;
+    void Widget::invalidateFocusChain() const {
+        if (window) { static_cast<Window *>(window)->_invalidateFocusChain(); }
     }
 
     std::shared_ptr<Widget> Widget::setFocus(const bool F) {
@@ -146,9 +140,10 @@ namespace lysa::ui {
                     refresh();
                 }
                 window->setFocusedWidget(shared_from_this());
-                ctx.events.push({UIEvent::OnGotFocus, {}, id});
+                emit(UIEvent::OnGotFocus);
             } else {
-                ctx.events.push({UIEvent::OnLostFocus, {}, id});
+                refresh();
+                emit(UIEvent::OnLostFocus);
                 /*shared_ptr<Widget>p = parent;
                 while (p && (!p->DrawBackground())) p = p->parent;
                 if (p) { p->Refresh(rect); }*/
@@ -159,6 +154,7 @@ namespace lysa::ui {
 
     void Widget::_allowFocus(const bool allow) {
         allowFocus = allow;
+        invalidateFocusChain();
         for (const auto &child : children) {
             child->_allowFocus(allow);
         }
@@ -170,6 +166,20 @@ namespace lysa::ui {
     }
 
     void Widget::_init(Widget &child, const Alignment alignment, const std::string &res, const bool overlap) {
+        attachChild(child, alignment, overlap);
+        static_cast<Style *>(style)->addResource(child, res);
+        childCreated(child);
+    }
+
+    void Widget::_init(Widget &child, const Alignment alignment, const ResourceDescriptor &res, const bool overlap) {
+        attachChild(child, alignment, overlap);
+        static_cast<Style *>(style)->addResource(child, res);
+        childCreated(child);
+    }
+
+    void Widget::attachChild(Widget &child, const Alignment alignment, const bool overlap) {
+        // The child has just been pushed at the end of the children
+        child.position = std::prev(children.end());
         child.alignment = alignment;
         child.overlap   = overlap;
         if (!child.font) { child.font = font; }
@@ -177,50 +187,114 @@ namespace lysa::ui {
         child.window = window;
         child.style  = style;
         child.parent = this;
-        static_cast<Style *>(style)->addResource(child, res);
+        child.hooks  = &static_cast<Style *>(style)->getHooks(child.type);
+        window->_getIndex().insert(child.shared_from_this());
+        window->_invalidateFocusChain();
+    }
+
+    void Widget::childCreated(Widget &child) {
         child.eventCreate();
         child.freeze = false;
+        if constexpr (FrameStats::ENABLED) {
+            if (const auto stats = getFrameStats()) { stats->count(&FrameStats::allocations); }
+        }
         if (static_cast<Window *>(window)->isVisible() && (resource != nullptr)) {
             resizeChildren();
         }
     }
 
     void Widget::remove(const std::shared_ptr<Widget>& W) {
-        const auto it = std::ranges::find(children, W);
-        if (it != children.end()) {
+        if (W->parent == this) {
             W->parent = nullptr;
-            // for (const auto& child : W->_getChildren()) {
-            //     W->remove(child);
-            // }
-            children.remove(W);
+            W->unindex();
+            invalidateFocusChain();
+            children.erase(W->position);
             resizeChildren();
         }
         refresh();
     }
 
     void Widget::removeAll() {
+        detachChildren();
+        invalidateFocusChain();
+        refresh();
+    }
+
+    void Widget::detachChildren() {
         for (const auto &child : children) {
-            child->removeAll();
+            child->detachChildren();
+            child->parent = nullptr;
+            if (window) { window->_getIndex().erase(child->id); }
         }
         children.clear();
+    }
+
+    void Widget::unindex() {
+        if (window) { window->_getIndex().erase(id); }
+        for (const auto &child : children) {
+            child->unindex();
+        }
+    }
+
+    void Widget::destroyChildren() {
+        for (const auto &child : children) {
+            child->teardown();
+        }
+        children.clear();
+        invalidateFocusChain();
+        resizeChildren();
         refresh();
     }
 
+    void Widget::teardown() {
+        for (const auto &child : children) {
+            child->teardown();
+        }
+        children.clear();
+        // Silently, the focus events would be sent by a destroyed widget
+        if (focused) {
+            focused = false;
+            if (window) { window->_clearFocusedWidget(); }
+        }
+        if (notifyDestroy) { emit(UIEvent::OnDestroy, UIEvent{}); }
+        if (window) { window->_getIndex().erase(id); }
+        parent = nullptr;
+    }
+
+    void Widget::emit(const std::string& type, std::any payload) {
+        if (window && window->isUpdating()) {
+            window->_deferEvent(type, std::move(payload), id);
+            return;
+        }
+        if constexpr (FrameStats::ENABLED) {
+            if (const auto stats = getFrameStats()) { stats->count(&FrameStats::eventsPushed); }
+        }
+        ctx.events.push({type, std::move(payload), id});
+    }
+
+    FrameStatsCollector* Widget::getFrameStats() const {
+        if constexpr (FrameStats::ENABLED) {
+            if (window) { return static_cast<Window *>(window)->_getFrameStats(); }
+        }
+        return nullptr;
+    }
+
     void Widget::eventCreate() {
-        ctx.events.push({UIEvent::OnCreate,  UIEvent{}, id});
+        emit(UIEvent::OnCreate, UIEvent{});
     }
 
     void Widget::eventDestroy() {
         for (const auto &child : children) {
             child->eventDestroy();
         }
-        ctx.events.push({UIEvent::OnDestroy,  UIEvent{}, id});
+        emit(UIEvent::OnDestroy, UIEvent{});
+        if (window) { window->_getIndex().erase(id); }
         children.clear();
     }
 
     void Widget::eventShow() {
         if (visible) {
-            ctx.events.push({UIEvent::OnShow,  UIEvent{}, id});
+            emit(UIEvent::OnShow, UIEvent{});
             for (const auto &child : children) {
                 child->eventShow();
             }
@@ -238,12 +312,12 @@ namespace lysa::ui {
             if (parent) {
                 parent->refresh();
             }
-            ctx.events.push({UIEvent::OnHide,  UIEvent{}, id});
+            emit(UIEvent::OnHide, UIEvent{});
         }
     }
 
     void Widget::eventEnable() {
-        ctx.events.push({UIEvent::OnEnable,  UIEvent{}, id});
+        emit(UIEvent::OnEnable, UIEvent{});
         for (const auto &child : children) {
             child->enable();
         }
@@ -254,22 +328,31 @@ namespace lysa::ui {
         for (const auto &child : children) {
             child->enable(false);
         }
-        ctx.events.push({UIEvent::OnDisable,  UIEvent{}, id});
+        emit(UIEvent::OnDisable, UIEvent{});
         refresh();
     }
 
     void Widget::eventMove(const float X, const float Y) {
-        const float diffX = rect.x - X;
-        const float diffY = rect.y - Y;
-        rect.x            = X;
-        rect.y            = Y;
-        for (const auto &w : children) {
-            w->setPos(w->rect.x - diffX, w->rect.y - diffY);
-        }
+        place(X, Y);
+        refresh();
+    }
+
+    void Widget::place(const float x, const float y) {
         if (parent) {
-            parent->refresh();
+            const auto& parentRect = parent->getRect();
+            localX = x - parentRect.x;
+            localY = y - parentRect.y;
+        } else {
+            localX = x;
+            localY = y;
+        }
+        rect.x = x;
+        rect.y = y;
+        if (window) {
+            // Invalidates the positions of all the widgets of the Window, recomputed when used
+            window->_movedWidget();
+            rectEpoch = window->_getPositionsEpoch();
         }
-        refresh();
     }
 
     void Widget::eventResize() {
@@ -282,14 +365,20 @@ namespace lysa::ui {
     }
 
     void Widget::resizeChildren() {
-        if (!style || freeze) {
+        if (!style || freeze || window->_deferLayout()) {
             return;
         }
         freeze = true;
+        auto span = Trace::Scope{"Widget::resizeChildren"};
+        const auto stats = getFrameStats();
+        auto layoutScope = FrameStatsCollector::Scope{stats, &FrameStats::layoutTime};
+        if (stats) { stats->count(&FrameStats::layoutPasses); }
+        if (const auto tracer = static_cast<Window *>(window)->_getRefreshTracer()) { tracer->layout(id); }
         Rect r = getRect();
-        static_cast<Style *>(style)->resize(*this, r, *resource);
+        const auto *h = static_cast<const Style::TypeHooks *>(hooks);
+        if (h->resize) { h->resize(*static_cast<const Style *>(style), *this, r, *resource); }
 
-        Rect clientRect = rect;
+        Rect clientRect = getRect();
         clientRect.x += hborder + padding;
         if (clientRect.width > (2 * hborder + 2 * padding)) {
             clientRect.width -= 2 * hborder + 2 * padding;
@@ -498,6 +587,7 @@ namespace lysa::ui {
                 break;
             }
             child->setRect(childRect);
+            if (stats) { stats->count(&FrameStats::widgetsLaidOut); }
             ++it;
         }
         freeze = false;
@@ -507,7 +597,7 @@ namespace lysa::ui {
         if (!enabled) {
             return false;
         }
-        ctx.events.push({UIEvent::OnKeyDown, UIEventKeyb{.key = key}, id});
+        emit(UIEvent::OnKeyDown, UIEventKeyb{.key = key});
         return false;
     }
 
@@ -516,7 +606,7 @@ namespace lysa::ui {
             return false;
         }
         if (focused) {
-            ctx.events.push({UIEvent::OnKeyUp, UIEventKeyb{.key = key}, id});
+            emit(UIEvent::OnKeyUp, UIEventKeyb{.key = key});
             return true;
         }
         return false;
@@ -544,7 +634,7 @@ namespace lysa::ui {
         if (redrawOnMouseEvent) {
             refresh();
         }
-        ctx.events.push({UIEvent::OnMouseDown, UIEventMouseButton{.button = button, .x = x, .y = y}, id});
+        emit(UIEvent::OnMouseDown, UIEventMouseButton{.button = button, .x = x, .y = y});
         return consumed;
     }
 
@@ -563,11 +653,11 @@ namespace lysa::ui {
             }
         }
         if (redrawOnMouseEvent) { refresh();}
-        ctx.events.push(Event { UIEvent::OnMouseUp, UIEventMouseButton{
+        emit(UIEvent::OnMouseUp, UIEventMouseButton{
             .button = button,
             .x = x,
             .y = y
-        }, id});
+        });
         return consumed;
     }
 
@@ -576,7 +666,7 @@ namespace lysa::ui {
             return false;
         }
         auto consumed = false;
-        auto p = rect.contains(x, y);
+        auto p = getRect().contains(x, y);
         for (auto &w : children) {
             p = w->getRect().contains(x, y);
             if (w->redrawOnMouseMove && (w->pointed != p)) {
@@ -591,41 +681,46 @@ namespace lysa::ui {
         if (redrawOnMouseMove && (pointed != p)) {
             refresh();
         }
-        ctx.events.push({UIEvent::OnMouseMove, UIEventMouseMove{.buttonsState = B, .x = x, .y = y}, id});
+        emit(UIEvent::OnMouseMove, UIEventMouseMove{.buttonsState = B, .x = x, .y = y});
         return consumed;
     }
 
     void Widget::eventGotFocus() {
-        ctx.events.push({UIEvent::OnGotFocus,  UIEvent{}, id});
+        emit(UIEvent::OnGotFocus, UIEvent{});
     }
 
     void Widget::eventLostFocus() {
-        ctx.events.push({UIEvent::OnLostFocus,  UIEvent{}, id});
+        emit(UIEvent::OnLostFocus, UIEvent{});
     }
 
     void Widget::setTransparency(const float alpha) {
+        if (transparency == alpha) { return; }
         transparency = alpha;
         refresh();
     }
 
     void Widget::setPadding(const float P) {
+        if (padding == P) { return; }
         padding = P;
         eventResize();
     }
 
     void Widget::setDrawBackground(const bool D) {
+        if (drawBackground == D) { return; }
         drawBackground = D;
         refresh();
     }
 
     void Widget::setAlignment(const Alignment ALIGN) {
+        if (alignment == ALIGN) { return; }
         alignment = ALIGN;
         eventResize();
     }
 
-    void Widget::refresh() const {
+    void Widget::refresh(const std::source_location& location) const {
+        generation += 1;
         if ((!freeze) && (window)) {
-            static_cast<Window *>(window)->refresh();
+            static_cast<Window *>(window)->_refresh(id, location);
         }
     }
 
@@ -663,7 +758,15 @@ namespace lysa::ui {
 
     bool Widget::isFocused() const { return focused; }
 
-    const Rect &Widget::getRect() const { return rect; }
+    const Rect &Widget::getRect() const {
+        if (parent && window && (rectEpoch != window->_getPositionsEpoch())) {
+            const auto& parentRect = parent->getRect();
+            rect.x = parentRect.x + localX;
+            rect.y = parentRect.y + localY;
+            rectEpoch = window->_getPositionsEpoch();
+        }
+        return rect;
+    }
 
     void Widget::setRect(const float x, const float y, const float width, const float height) {
         setPos(x, y);
@@ -685,6 +788,7 @@ namespace lysa::ui {
     float Widget::getHBorder() const { return hborder; }
 
     void Widget::setVBorder(const float size) {
+        if (vborder == size) { return; }
         vborder = size;
         if (!freeze) {
             resizeChildren();
@@ -693,6 +797,7 @@ namespace lysa::ui {
     }
 
     void Widget::setHBorder(const float size) {
+        if (hborder == size) { return; }
         hborder = size;
         if (!freeze) {
             resizeChildren();
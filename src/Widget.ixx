@@ -11,10 +11,12 @@ import lysa.exception;
 import lysa.rect;
 import lysa.input_event;
 import lysa.types;
-import lysa.renderers.vector_2d;
+import lysa.ui.draw_sink;
 import lysa.resources;
 import lysa.resources.font;
 import lysa.ui.alignment;
+import lysa.ui.frame_stats;
+import lysa.ui.resource_descriptor;
 import lysa.ui.uiresource;
 
 namespace lysa::ui {
@@ -26,8 +28,11 @@ namespace lysa::ui {
     public:
         /**
          * Widget type enumeration.
+         *
+         * User defined widgets use identifiers starting at CUSTOM and register
+         * their drawing functions with Style::registerType().
          */
-        enum Type {
+        enum Type : uint32 {
             //! transparent widget
             WIDGET,
             //! rectangular widget with only a background
@@ -52,6 +57,8 @@ namespace lysa::ui {
             TREEVIEW,
             //! 2D Image
             IMAGE,
+            //! First identifier available for user defined widget types
+            CUSTOM = 1024,
         };
 
         /**
@@ -109,7 +116,7 @@ namespace lysa::ui {
         virtual void setSize(float width, float height);
 
         /**
-         * Returns the size & the position of the widget.
+         * Returns the size & the position of the widget, relative to the Window.
          */
         const Rect &getRect() const;
 
@@ -186,6 +193,26 @@ namespace lysa::ui {
                 resource);
         }
 
+        /**
+         * Creates & adds a child widget using a resource description parsed at compile time.
+         * @tparam T The type of the widget to create.
+         * @tparam Args The types of the arguments to pass to the widget constructor.
+         * @param resource The resource description, usually `res<"...">`.
+         * @param alignment The alignment of the child widget.
+         * @param args The arguments to pass to the widget constructor.
+         * @return A shared pointer to the created widget.
+         */
+        template<typename T, typename... Args>
+        std::shared_ptr<T> create(
+            const ResourceDescriptor & resource,
+            const Alignment alignment,
+            Args&&... args) {
+            return add(
+                std::make_shared<T>(ctx, std::forward<Args>(args)...),
+                alignment,
+                resource);
+        }
+
         /**
          * Creates & adds a child widget.
          * @tparam T The type of the widget to create.
@@ -227,6 +254,28 @@ namespace lysa::ui {
             return child;
         }
 
+        /**
+         * Adds a child widget using a resource description parsed at compile time.
+         * @tparam T The type of the widget to add.
+         * @param child Child widget to add.
+         * @param alignment Placement alignment.
+         * @param resource Resource description, usually `res<"...">`.
+         * @param overlap Overlap widget on top of other widgets.
+         * @return A shared pointer to the added widget.
+         */
+        template<typename T>
+        std::shared_ptr<T> add(
+            std::shared_ptr<T> child,
+            const Alignment alignment,
+            const ResourceDescriptor &resource,
+            const bool overlap = false) {
+            assert([&]{return window != nullptr;}, "Widget must be added to a Window before adding child");
+            if (!allowChildren) { return child; }
+            children.push_back(child);
+            _init(*child, alignment, resource, overlap);
+            return child;
+        }
+
         /**
          * Removes a child widget.
          */
@@ -237,6 +286,21 @@ namespace lysa::ui {
          */
         virtual void removeAll();
 
+        /**
+         * Destroys all children widgets recursively, with one layout & one refresh.
+         *
+         * Unlike eventDestroy(), UIEvent::OnDestroy is pushed only for the widgets
+         * that requested it with setNotifyDestroy(). A focused child loses the focus
+         * without UIEvent::OnLostFocus.
+         */
+        void destroyChildren();
+
+        /**
+         * Sets whether destroyChildren() pushes UIEvent::OnDestroy for this widget.
+         * Enable it when subscribing to the UIEvent::OnDestroy event of the widget.
+         */
+        void setNotifyDestroy(const bool notify) { notifyDestroy = notify; }
+
         /**
          * Changes children padding (space between children).
          */
@@ -315,17 +379,27 @@ namespace lysa::ui {
         /**
          * Sets whether the widget is pushed.
          */
-        void setPushed(const bool p) { pushed = p; }
+        void setPushed(const bool p) {
+            if (pushed == p) { return; }
+            pushed = p;
+            refresh();
+        }
 
         /**
          * Force a refresh of the entire widget.
+         * @param location Call site, recorded when the refresh tracing is enabled.
          */
-        void refresh() const;
+        void refresh(const std::source_location& location = std::source_location::current()) const;
+
+        /**
+         * Returns the visual generation of the widget, advanced each time its drawn state changes.
+         */
+        auto getGeneration() const { return generation; }
 
         /**
          * Changes widget resources.
          */
-        void setResource(std::shared_ptr<UIResource> resource);
+        void setResource(std::shared_ptr<const UIResource> resource);
 
         /**
          * Returns the user defined group index.
@@ -368,7 +442,7 @@ namespace lysa::ui {
 
         virtual std::list<std::shared_ptr<Widget>>& _getChildren() { return children; }
 
-        void _draw(Vector2DRenderer &) const;
+        void _draw(DrawSink &) const;
 
         std::shared_ptr<Widget> setFocus(bool = true);
 
@@ -408,9 +482,11 @@ namespace lysa::ui {
 
     protected:
         friend class Window;
+        friend class UpdateScope;
         Context& ctx;
         const Type type;
-        Rect rect;
+        // Position relative to the Window, recomputed from the parent position after a move, see getRect()
+        mutable Rect rect;
         Rect defaultRect;
         float hborder{0};
         float vborder{0};
@@ -426,10 +502,12 @@ namespace lysa::ui {
         float transparency{1.0f};
         Widget* parent{nullptr};
         Alignment alignment{Alignment::NONE};
-        std::shared_ptr<UIResource> resource;
+        std::shared_ptr<const UIResource> resource;
         std::list<std::shared_ptr<Widget>> children;
         Window* window{nullptr};
         void* style{nullptr};
+        // Style::TypeHooks of the widget type, resolved once when the widget is added
+        const void* hooks{nullptr};
         bool mouseMoveOnFocus{false};
         float fontScale{0.0f};
 
@@ -437,6 +515,15 @@ namespace lysa::ui {
 
         virtual void _init(Widget &child, Alignment alignment, const std::string &res, bool overlap);
 
+        virtual void _init(Widget &child, Alignment alignment, const ResourceDescriptor &res, bool overlap);
+
+        /**
+         * Pushes a UI event for this widget to the engine events queue.
+         * @param type One of the UIEvent signals.
+         * @param payload The event parameters.
+         */
+        void emit(const std::string& type, std::any payload = {});
+
     private:
         bool pushed{false};
         bool pointed{false};
@@ -445,9 +532,38 @@ namespace lysa::ui {
         bool visible{true};
         void *userData{nullptr};
         int32 groupIndex{0};
+        bool notifyDestroy{false};
+        mutable uint32 generation{0};
+        // Position relative to the parent
+        float localX{0.0f};
+        float localY{0.0f};
+        // Window positions epoch of rect.x & rect.y
+        mutable uint32 rectEpoch{0};
+        // Position in the Window focus chain, valid only if the chain holds this widget at this index
+        int32 focusIndex{-1};
+        // Position in the parent children, for O(1) removal
+        std::list<std::shared_ptr<Widget>>::iterator position;
         Rect childrenRect;
         std::shared_ptr<Font> font{nullptr};
 
         std::shared_ptr<Widget> setNextFocus();
+
+        void invalidateFocusChain() const;
+
+        // Changes the position of the widget relative to the Window, the children follow without being visited
+        void place(float x, float y);
+
+        void attachChild(Widget &child, Alignment alignment, bool overlap);
+
+        void childCreated(Widget &child);
+
+        void detachChildren();
+
+        // Removes the widget & its children from the Window index
+        void unindex();
+
+        void teardown();
+
+        FrameStatsCollector* getFrameStats() const;
     };
 }
\ No newline at end of file
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+module lysa.ui.widget_index;
+
+namespace lysa::ui {
+
+    std::size_t WidgetIndex::indexOf(const unique_id id) const {
+        // Fibonacci hashing, ids are mostly sequential
+        return static_cast<std::size_t>((static_cast<std::uint64_t>(id) * 11400714819323198485ull) >> 32) & (slots.size() - 1);
+    }
+
+    void WidgetIndex::insert(const std::shared_ptr<Widget>& widget) {
+        // Keeps at least a quarter of empty slots to bound the probes
+        if ((count + erased + 1) * 4 > slots.size() * 3) {
+            rehash(std::max(MIN_CAPACITY, std::bit_ceil(static_cast<std::size_t>(count + 1) * 2)));
+        }
+        const auto mask = slots.size() - 1;
+        auto free = slots.size();
+        for (auto index = indexOf(widget->id); ; index = (index + 1) & mask) {
+            auto& slot = slots[index];
+            if (slot.state == State::USED && slot.id == widget->id) {
+                slot.widget = widget;
+                return;
+            }
+            if (slot.state == State::ERASED && free == slots.size()) {
+                free = index;
+            } else if (slot.state == State::EMPTY) {
+                if (free == slots.size()) {
+                    free = index;
+                } else {
+                    erased -= 1;
+                }
+                break;
+            }
+        }
+        slots[free] = {State::USED, widget->id, widget};
+        count += 1;
+    }
+
+    void WidgetIndex::erase(const unique_id id) {
+        if (slots.empty()) { return; }
+        const auto mask = slots.size() - 1;
+        for (auto index = indexOf(id); slots[index].state != State::EMPTY; index = (index + 1) & mask) {
+            auto& slot = slots[index];
+            if (slot.state == State::USED && slot.id == id) {
+                slot.state = State::ERASED;
+                slot.widget.reset();
+                count -= 1;
+                erased += 1;
+                return;
+            }
+        }
+    }
+
+    std::shared_ptr<Widget> WidgetIndex::find(const unique_id id) const {
+        if (slots.empty()) { return nullptr; }
+        const auto mask = slots.size() - 1;
+        for (auto index = indexOf(id); slots[index].state != State::EMPTY; index = (index + 1) & mask) {
+            const auto& slot = slots[index];
+            if (slot.state == State::USED && slot.id == id) {
+                return slot.widget.lock();
+            }
+        }
+        return nullptr;
+    }
+
+    void WidgetIndex::clear() {
+        slots.clear();
+        count = 0;
+        erased = 0;
+    }
+
+    void WidgetIndex::rehash(const std::size_t capacity) {
+        auto old = std::exchange(slots, std::vector<Slot>(capacity));
+        count = 0;
+        erased = 0;
+        const auto mask = capacity - 1;
+        for (auto& slot : old) {
+            // Destroyed widgets are dropped while rehashing
+            if (slot.state != State::USED || slot.widget.expired()) { continue; }
+            auto index = indexOf(slot.id);
+            while (slots[index].state != State::EMPTY) { index = (index + 1) & mask; }
+            slots[index] = std::move(slot);
+            count += 1;
+        }
+    }
+
+}
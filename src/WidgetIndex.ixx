@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+export module lysa.ui.widget_index;
+
+import std;
+import lysa.types;
+import lysa.ui.widget;
+
+export namespace lysa::ui {
+
+    /**
+     * Open addressing hash table of widgets by id, holding weak references.
+     */
+    class WidgetIndex {
+    public:
+        /**
+         * Adds or replaces a widget.
+         */
+        void insert(const std::shared_ptr<Widget>& widget);
+
+        /**
+         * Removes a widget, if present.
+         */
+        void erase(unique_id id);
+
+        /**
+         * Returns a widget, or nullptr if not present or already destroyed.
+         */
+        std::shared_ptr<Widget> find(unique_id id) const;
+
+        /**
+         * Removes all the widgets.
+         */
+        void clear();
+
+        /**
+         * Returns the number of indexed widgets.
+         */
+        auto getSize() const { return count; }
+
+    private:
+        enum class State : uint8 { EMPTY, USED, ERASED };
+
+        struct Slot {
+            State state{State::EMPTY};
+            unique_id id{INVALID_ID};
+            std::weak_ptr<Widget> widget;
+        };
+
+        static constexpr std::size_t MIN_CAPACITY{64};
+
+        // Capacity is always a power of two
+        std::vector<Slot> slots;
+        uint32 count{0};
+        uint32 erased{0};
+
+        std::size_t indexOf(unique_id id) const;
+
+        void rehash(std::size_t capacity);
+    };
+
+}
@@ -11,9 +11,23 @@ import lysa.log;
 import lysa.rect;
 import lysa.renderers.vector_2d;
 import lysa.resources.font;
+import lysa.ui.box;
+import lysa.ui.button;
+import lysa.ui.check_widget;
+import lysa.ui.draw_sink;
 import lysa.ui.event;
+import lysa.ui.frame;
+import lysa.ui.image;
+import lysa.ui.line;
 import lysa.ui.panel;
+import lysa.ui.scroll_bar;
 import lysa.ui.style;
+import lysa.ui.text;
+import lysa.ui.text_edit;
+import lysa.ui.toggle_button;
+import lysa.ui.trace;
+import lysa.ui.tree_view;
+import lysa.ui.uiresource;
 import lysa.ui.widget;
 import lysa.ui.window_manager;
 
@@ -27,6 +41,8 @@ namespace lysa::ui {
     void Window::attach(WindowManager* windowManager) {
         assert([&]{ return this->windowManager == nullptr;} , "ui::Window must not be already attached to a manager");
         this->windowManager = windowManager;
+        this->frameStats = &windowManager->_getFrameStats();
+        this->refreshTracer = &windowManager->getRefreshTracer();
         this->fontScale = windowManager->getDefaultFontScale();
         this->font = windowManager->getDefaultFont();
         this->textColor = windowManager->getDefaultTextColor();
@@ -34,14 +50,16 @@ namespace lysa::ui {
 
     void Window::detach() {
         windowManager = nullptr;
+        frameStats = nullptr;
+        refreshTracer = nullptr;
     }
 
-    void Window::draw() const {
+    void Window::draw(DrawSink& sink) const {
         if (!isVisible()) { return; }
-        Vector2DRenderer& renderer = windowManager->getRenderer();
-        renderer.setTranslate({rect.x, rect.y});
-        renderer.setTransparency(1.0f - transparency);
-        widget->_draw(renderer);
+        auto span = Trace::Scope{"Window::draw"};
+        sink.setTranslate({rect.x, rect.y});
+        sink.setTransparency(1.0f - transparency);
+        widget->_draw(sink);
     }
 
     void Window::unFreeze(const std::shared_ptr<Widget> &widget) {
@@ -81,6 +99,9 @@ namespace lysa::ui {
         widget->setPadding(padding);
         widget->window = this;
         widget->style = layout.get();
+        widget->hooks = &layout->getHooks(widget->getType());
+        widgetsIndex.insert(widget);
+        focusChainValid = false;
         widget->setFont(static_cast<Style*>(widget->style)->getFont());
         static_cast<Style*>(widget->style)->addResource(*widget, resources);
         widget->eventCreate();
@@ -90,6 +111,257 @@ namespace lysa::ui {
         unFreeze(widget);
     }
 
+    std::vector<std::shared_ptr<Widget>> Window::createLayout(const LayoutFile& layoutFile) {
+        auto& root = getWidget();
+        const auto rootFreeze = root.freeze;
+        const auto widgets = instantiate(layoutFile);
+
+        // One layout for the whole tree
+        for (const auto& widget : widgets) {
+            widget->freeze = false;
+        }
+        root.freeze = rootFreeze;
+        root.resizeChildren();
+        refresh();
+        return widgets;
+    }
+
+    std::vector<std::shared_ptr<Widget>> Window::instantiate(const LayoutFile& layoutFile) {
+        auto& root = getWidget();
+        const auto nodes = layoutFile.getNodes();
+
+        // Allocation sweep, new widgets are frozen until the whole tree is built
+        auto widgets = std::vector<std::shared_ptr<Widget>>{};
+        widgets.reserve(nodes.size());
+        for (const auto& node : nodes) {
+            const auto text = std::string{layoutFile.getString(node.text)};
+            switch (node.widgetClass) {
+            case LayoutFile::WIDGET:       widgets.push_back(std::make_shared<Widget>(ctx)); break;
+            case LayoutFile::PANEL:        widgets.push_back(std::make_shared<Panel>(ctx)); break;
+            case LayoutFile::BOX:          widgets.push_back(std::make_shared<Box>(ctx)); break;
+            case LayoutFile::HLINE:        widgets.push_back(std::make_shared<HLine>(ctx)); break;
+            case LayoutFile::VLINE:        widgets.push_back(std::make_shared<VLine>(ctx)); break;
+            case LayoutFile::FRAME:        widgets.push_back(std::make_shared<Frame>(ctx, text)); break;
+            case LayoutFile::BUTTON:       widgets.push_back(std::make_shared<Button>(ctx)); break;
+            case LayoutFile::TOGGLEBUTTON: widgets.push_back(std::make_shared<ToggleButton>(ctx)); break;
+            case LayoutFile::TEXT:         widgets.push_back(std::make_shared<Text>(ctx, text)); break;
+            case LayoutFile::TEXTEDIT:     widgets.push_back(std::make_shared<TextEdit>(ctx, text)); break;
+            case LayoutFile::VSCROLLBAR:   widgets.push_back(std::make_shared<VScrollBar>(ctx)); break;
+            case LayoutFile::HSCROLLBAR:   widgets.push_back(std::make_shared<HScrollBar>(ctx)); break;
+            case LayoutFile::TREEVIEW:     widgets.push_back(std::make_shared<TreeView>(ctx)); break;
+            case LayoutFile::IMAGE:        widgets.push_back(std::make_shared<Image>(ctx)); break;
+            default: throw Exception("Unknown widget class in layout");
+            }
+        }
+
+        // Validation pass, nothing is attached before the whole layout is known to be valid
+        for (auto index = std::size_t{0}; index < nodes.size(); index++) {
+            const auto parent = nodes[index].parent;
+            if (parent != LayoutFile::NO_PARENT && parent >= index) {
+                throw Exception("Invalid parent in layout");
+            }
+            if (!(parent == LayoutFile::NO_PARENT ? root : *widgets[parent]).allowChildren) {
+                throw Exception("Widget can't have children in layout");
+            }
+        }
+
+        // Resources interning pass, identical descriptions share the same string offset
+        auto resources = std::unordered_map<uint32, std::shared_ptr<const UIResource>>{};
+        for (const auto& node : nodes) {
+            if (!resources.contains(node.resource)) {
+                resources[node.resource] = layout->getResource(std::string{layoutFile.getString(node.resource)});
+            }
+        }
+
+        // Attach pass, without any layout since all the parents are frozen
+        root.freeze = true;
+        for (auto index = std::size_t{0}; index < nodes.size(); index++) {
+            const auto& node = nodes[index];
+            auto& child = *widgets[index];
+            auto& parent = node.parent == LayoutFile::NO_PARENT ? root : *widgets[node.parent];
+            parent.children.push_back(widgets[index]);
+            parent.attachChild(child, LayoutFile::getAlignment(node), node.flags & LayoutFile::OVERLAP);
+            child.padding = node.padding;
+            layout->addResource(child, resources.at(node.resource));
+        }
+        for (const auto& widget : widgets) {
+            widget->eventCreate();
+        }
+        if (frameStats) { frameStats->count(&FrameStats::allocations, static_cast<uint32>(widgets.size())); }
+        return widgets;
+    }
+
+    WindowSnapshot Window::saveSnapshot() const {
+        auto snapshot = WindowSnapshot{};
+        snapshot.width = rect.width;
+        snapshot.height = rect.height;
+        for (const auto& child : getWidget().children) {
+            saveWidget(snapshot, *child, LayoutFile::NO_PARENT);
+        }
+        return snapshot;
+    }
+
+    void Window::saveWidget(WindowSnapshot& snapshot, const Widget& widget, const uint32 parent) const {
+        auto node = LayoutFile::Node{
+            .widgetClass = LayoutFile::CLASS_COUNT,
+            .alignment = static_cast<uint32>(widget.alignment),
+            .parent = parent,
+            .flags = widget.overlap ? LayoutFile::OVERLAP : 0u,
+            .padding = widget.padding,
+        };
+        auto state = WindowSnapshot::State{
+            .flags = (widget.visible ? 0u : WindowSnapshot::HIDDEN) | (widget.enabled ? 0u : WindowSnapshot::DISABLED),
+        };
+        // Children of composite widgets are created by the widgets themselves
+        auto composite = false;
+        switch (widget.getType()) {
+        case Widget::WIDGET: node.widgetClass = LayoutFile::WIDGET; break;
+        case Widget::PANEL:  node.widgetClass = LayoutFile::PANEL; break;
+        case Widget::BOX:    node.widgetClass = LayoutFile::BOX; break;
+        case Widget::LINE:
+            node.widgetClass = static_cast<const Line&>(widget).getStyle() == Line::VERT ? LayoutFile::VLINE : LayoutFile::HLINE;
+            break;
+        case Widget::FRAME:
+            node.widgetClass = LayoutFile::FRAME;
+            node.text = snapshot.layout.addString(static_cast<const Frame&>(widget).getTitle());
+            break;
+        case Widget::BUTTON: node.widgetClass = LayoutFile::BUTTON; break;
+        case Widget::TOGGLEBUTTON:
+            node.widgetClass = LayoutFile::TOGGLEBUTTON;
+            if (static_cast<const CheckWidget&>(widget).getState() == CheckWidget::CHECK) {
+                state.flags |= WindowSnapshot::CHECKED;
+            }
+            break;
+        case Widget::TEXT:
+            node.widgetClass = LayoutFile::TEXT;
+            node.text = snapshot.layout.addString(static_cast<const Text&>(widget).getText());
+            break;
+        case Widget::TEXTEDIT:
+            node.widgetClass = LayoutFile::TEXTEDIT;
+            node.text = snapshot.layout.addString(static_cast<const TextEdit&>(widget).getText());
+            composite = true;
+            break;
+        case Widget::SCROLLBAR: {
+            const auto& scrollBar = static_cast<const ScrollBar&>(widget);
+            node.widgetClass = scrollBar.getScrollBarType() == ScrollBar::VERTICAL ? LayoutFile::VSCROLLBAR : LayoutFile::HSCROLLBAR;
+            state.min = scrollBar.getMin();
+            state.max = scrollBar.getMax();
+            state.value = scrollBar.getValue();
+            state.step = scrollBar.getStep();
+            composite = true;
+            break;
+        }
+        case Widget::TREEVIEW:
+            node.widgetClass = LayoutFile::TREEVIEW;
+            composite = true;
+            break;
+        case Widget::IMAGE: node.widgetClass = LayoutFile::IMAGE; break;
+        default:
+            // User defined widgets can't be recreated
+            return;
+        }
+        if (widget.resource) { node.resource = snapshot.layout.addString(widget.resource->getResource()); }
+        const auto index = snapshot.layout.addNode(node);
+        snapshot.states.push_back(state);
+        saveGeometry(snapshot, widget, composite);
+        if (!composite) {
+            for (const auto& child : widget.children) {
+                saveWidget(snapshot, *child, index);
+            }
+        }
+    }
+
+    void Window::saveGeometry(WindowSnapshot& snapshot, const Widget& widget, const bool withChildren) {
+        snapshot.geometries.push_back({
+            widget.getRect().x, widget.getRect().y, widget.rect.width, widget.rect.height,
+            widget.defaultRect.x, widget.defaultRect.y, widget.defaultRect.width, widget.defaultRect.height,
+            widget.hborder, widget.vborder,
+        });
+        if (withChildren) {
+            for (const auto& child : widget.children) {
+                saveGeometry(snapshot, *child, true);
+            }
+        }
+    }
+
+    void Window::collectWidgets(Widget& widget, std::vector<Widget*>& widgets) {
+        widgets.push_back(&widget);
+        for (const auto& child : widget.children) {
+            collectWidgets(*child, widgets);
+        }
+    }
+
+    std::vector<std::shared_ptr<Widget>> Window::restoreSnapshot(const WindowSnapshot& snapshot) {
+        auto& root = getWidget();
+        root.removeAll();
+        const auto rootFreeze = root.freeze;
+        const auto widgets = instantiate(snapshot.layout);
+
+        const auto nodes = snapshot.layout.getNodes();
+        for (auto index = std::size_t{0}; index < widgets.size(); index++) {
+            const auto& state = snapshot.states[index];
+            auto& widget = *widgets[index];
+            if (state.flags & WindowSnapshot::DISABLED) { widget.enable(false); }
+            if (state.flags & WindowSnapshot::HIDDEN) { widget.show(false); }
+            switch (nodes[index].widgetClass) {
+            case LayoutFile::TOGGLEBUTTON:
+                if (state.flags & WindowSnapshot::CHECKED) {
+                    static_cast<CheckWidget&>(widget).setState(CheckWidget::CHECK);
+                }
+                break;
+            case LayoutFile::VSCROLLBAR:
+            case LayoutFile::HSCROLLBAR: {
+                auto& scrollBar = static_cast<ScrollBar&>(widget);
+                if (state.min > scrollBar.getMax()) {
+                    scrollBar.setMax(state.max);
+                    scrollBar.setMin(state.min);
+                } else {
+                    scrollBar.setMin(state.min);
+                    scrollBar.setMax(state.max);
+                }
+                scrollBar.setStep(state.step);
+                scrollBar.setValue(state.value);
+                break;
+            }
+            default:
+                break;
+            }
+        }
+
+        // All the widgets of the tree, including the children created by composite widgets
+        auto all = std::vector<Widget*>{};
+        for (const auto& child : root.children) {
+            collectWidgets(*child, all);
+        }
+        const auto geometries = snapshot.getGeometries();
+        const auto useGeometries =
+            snapshot.width == rect.width &&
+            snapshot.height == rect.height &&
+            all.size() == geometries.size();
+        if (useGeometries) {
+            for (auto index = std::size_t{0}; index < all.size(); index++) {
+                const auto& geometry = geometries[index];
+                auto& widget = *all[index];
+                widget.place(geometry.x, geometry.y);
+                widget.rect.width = geometry.width;
+                widget.rect.height = geometry.height;
+                widget.defaultRect.x = geometry.defaultX;
+                widget.defaultRect.y = geometry.defaultY;
+                widget.defaultRect.width = geometry.defaultWidth;
+                widget.defaultRect.height = geometry.defaultHeight;
+                widget.hborder = geometry.hborder;
+                widget.vborder = geometry.vborder;
+            }
+        }
+        for (const auto& widget : all) {
+            widget->freeze = false;
+        }
+        root.freeze = rootFreeze;
+        if (!useGeometries) { root.resizeChildren(); }
+        refresh();
+        return widgets;
+    }
+
     void Window::setStyle(const std::shared_ptr<Style>& style) {
         if (layout == nullptr) {
             layout = Style::create();
@@ -99,6 +371,18 @@ namespace lysa::ui {
         refresh();
     }
 
+    void Window::applyTheme(const Style::Options& options) {
+        layout->applyTheme(options);
+        if (widget) { widget->resizeChildren(); }
+        refresh();
+    }
+
+    void Window::setTheme(const std::shared_ptr<const Style::ThemeSnapshot>& theme) {
+        layout->setTheme(theme);
+        if (widget) { widget->resizeChildren(); }
+        refresh();
+    }
+
     void Window::setVisible(const bool isVisible) {
         if (visible != isVisible) {
             visibilityChange  = isVisible;
@@ -127,6 +411,9 @@ namespace lysa::ui {
 
     void Window::eventDestroy() {
         if (widget) { widget->eventDestroy(); }
+        widgetsIndex.clear();
+        focusChain.clear();
+        focusChainValid = false;
         // emit(UIEvent::OnDestroy);
         onDestroy();
         widget.reset();
@@ -140,6 +427,12 @@ namespace lysa::ui {
     }
 
     bool Window::eventKeyDown(const Key K) {
+        const auto dispatch = Dispatch{*this};
+        if ((K == KEY_LEFT_SHIFT) || (K == KEY_RIGHT_SHIFT)) {
+            shiftPressed = true;
+        } else if ((K == KEY_TAB) && (shiftPressed ? focusPrevious() : focusNext())) {
+            return true;
+        }
         bool consumed = false;
         if (focusedWidget) {
             focusedWidget->eventKeyDown(K);
@@ -150,13 +443,16 @@ namespace lysa::ui {
         }
         if (!consumed) {
             auto event = UIEventKeyb{.key = K};
-            ctx.events.push({UIEvent::OnKeyDown, event, id});
+            emit(UIEvent::OnKeyDown, event);
         }
-        refresh();
         return consumed;
     }
 
     bool Window::eventKeyUp(const Key K) {
+        const auto dispatch = Dispatch{*this};
+        if ((K == KEY_LEFT_SHIFT) || (K == KEY_RIGHT_SHIFT)) {
+            shiftPressed = false;
+        }
         bool consumed = false;
         if (focusedWidget) {
             focusedWidget->eventKeyUp(K);
@@ -167,13 +463,13 @@ namespace lysa::ui {
         }
         if (!consumed) {
             auto event = UIEventKeyb{.key = K};
-            ctx.events.push({UIEvent::OnKeyUp, event, id});
+            emit(UIEvent::OnKeyUp, event);
         }
-        refresh();
         return consumed;
     }
 
     bool Window::eventMouseDown(const MouseButton B, const float X, const float Y) {
+        const auto dispatch = Dispatch{*this};
         if (!visible) { return false; }
         bool consumed = false;
         if (widget) {
@@ -183,13 +479,13 @@ namespace lysa::ui {
             consumed |= onMouseDown(B, X, Y);
         }
         if (!consumed) {
-            ctx.events.push({UIEvent::OnMouseDown, UIEventMouseButton{.button = B, .x = X, .y = Y}, id});
+            emit(UIEvent::OnMouseDown, UIEventMouseButton{.button = B, .x = X, .y = Y});
         }
-        refresh();
         return consumed;
     }
 
     bool Window::eventMouseUp(const MouseButton B, const float X, const float Y) {
+        const auto dispatch = Dispatch{*this};
         if (!visible) { return false; }
         bool consumed = false;
         if (widget) {
@@ -199,13 +495,13 @@ namespace lysa::ui {
             consumed |= onMouseUp(B, X, Y);
         }
         if (!consumed) {
-            ctx.events.push({UIEvent::OnMouseUp, UIEventMouseButton{.button = B, .x = X, .y = Y}, id});
+            emit(UIEvent::OnMouseUp, UIEventMouseButton{.button = B, .x = X, .y = Y});
         }
-        refresh();
         return consumed;
     }
 
     bool Window::eventMouseMove(const uint32 B, const float X, const float Y) {
+        const auto dispatch = Dispatch{*this};
         if (!visible) { return false; }
         bool consumed = false;
         if ((focusedWidget != nullptr) &&
@@ -218,14 +514,91 @@ namespace lysa::ui {
             consumed |= onMouseMove(B, X, Y);
         }
         if (!consumed) {
-            ctx.events.push({UIEvent::OnMouseMove, UIEventMouseMove{.buttonsState = B, .x = X, .y = Y}, id});
+            emit(UIEvent::OnMouseMove, UIEventMouseMove{.buttonsState = B, .x = X, .y = Y});
         }
-        if (consumed) { refresh(); }
         return consumed;
     }
 
-    void Window::refresh() const {
-        if (windowManager) { windowManager->refresh(); }
+    void Window::emit(const std::string& type, std::any payload) {
+        if (updateDepth > 0) {
+            _deferEvent(type, std::move(payload), id);
+            return;
+        }
+        if (frameStats) { frameStats->count(&FrameStats::eventsPushed); }
+        ctx.events.push({type, std::move(payload), id});
+    }
+
+    void Window::endUpdate() {
+        updateDepth -= 1;
+        if (updateDepth > 0) { return; }
+        if (layoutDeferred) {
+            layoutDeferred = false;
+            if (widget) { widget->resizeChildren(); }
+        }
+        if (refreshDeferred) {
+            refreshDeferred = false;
+            refresh();
+        }
+        // Moved out, the events handlers can open another scope
+        auto events = std::move(deferredEvents);
+        deferredEvents.clear();
+        for (auto& event : events) {
+            if (frameStats) { frameStats->count(&FrameStats::eventsPushed); }
+            ctx.events.push({event.type, std::move(event.payload), event.source});
+        }
+    }
+
+    UpdateScope::UpdateScope(Window& window):
+        window{&window},
+        exceptions{std::uncaught_exceptions()} {
+        window.beginUpdate();
+    }
+
+    UpdateScope::UpdateScope(const Widget& widget):
+        window{widget.window},
+        exceptions{std::uncaught_exceptions()} {
+        assert([&]{ return window != nullptr;} , "Widget must be added to a Window before opening an UpdateScope");
+        window->beginUpdate();
+    }
+
+    UpdateScope::~UpdateScope() noexcept(false) {
+        if (std::uncaught_exceptions() > exceptions) {
+            // Already unwinding, the tree is laid out but a second exception can't be thrown
+            try { window->endUpdate(); } catch (...) { }
+        } else {
+            window->endUpdate();
+        }
+    }
+
+    void Window::refresh(const std::source_location& location) const {
+        _refresh(id, location);
+    }
+
+    void Window::_refresh(const unique_id source, const std::source_location& location) const {
+        generation += 1;
+        if (updateDepth > 0) {
+            refreshDeferred = true;
+            return;
+        }
+        if (!windowManager) { return; }
+        if (dispatchDepth > 0) {
+            windowManager->_traceRefresh(source, location);
+        } else {
+            windowManager->_refresh(source, location);
+        }
+    }
+
+    Window::Dispatch::Dispatch(Window& window):
+        window{window},
+        generation{window.generation} {
+        window.dispatchDepth += 1;
+    }
+
+    Window::Dispatch::~Dispatch() {
+        window.dispatchDepth -= 1;
+        if ((window.dispatchDepth == 0) && (window.generation != generation) && window.windowManager) {
+            window.windowManager->_redraw();
+        }
     }
 
     void Window::setFocusedWidget(const std::shared_ptr<Widget> &W) {
@@ -235,6 +608,32 @@ namespace lysa::ui {
         focusedWidget = W;
     }
 
+    std::shared_ptr<Widget> Window::_focusStep(const Widget* from, const int32 step) {
+        if (!focusChainValid) {
+            focusChain.clear();
+            if (widget) { buildFocusChain(*widget); }
+            focusChainValid = true;
+        }
+        if (focusChain.empty()) { return nullptr; }
+        const auto size = static_cast<int32>(focusChain.size());
+        auto index = step > 0 ? 0 : size - 1;
+        if (from && (from->focusIndex >= 0) && (from->focusIndex < size) && (focusChain[from->focusIndex] == from)) {
+            index = ((from->focusIndex + step) % size + size) % size;
+        }
+        return focusChain[index]->setFocus();
+    }
+
+    void Window::buildFocusChain(Widget& widget) {
+        if (!widget.visible) { return; }
+        if (widget.allowFocus && widget.enabled) {
+            widget.focusIndex = static_cast<int32>(focusChain.size());
+            focusChain.push_back(&widget);
+        }
+        for (const auto& child : widget.children) {
+            buildFocusChain(*child);
+        }
+    }
+
     Widget &Window::getWidget() const {
         assert([&]{ return windowManager != nullptr;} , "ui::Window not attached to a manager");
         return *widget;
@@ -296,7 +695,7 @@ namespace lysa::ui {
     }
 
     void Window::eventMove() {
-        if (widget) { widget->resizeChildren(); }
+        // The widgets positions are relative to the Window, they don't change
         onMove();
         // emit(UIEvent::OnMove);
         refresh();
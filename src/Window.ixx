@@ -14,8 +14,15 @@ import lysa.renderers.vector_2d;
 import lysa.resources;
 import lysa.resources.font;
 import lysa.ui.alignment;
+import lysa.ui.draw_sink;
+import lysa.ui.frame_stats;
+import lysa.ui.refresh_tracer;
+import lysa.ui.layout_file;
+import lysa.ui.resource_descriptor;
 import lysa.ui.style;
 import lysa.ui.widget;
+import lysa.ui.widget_index;
+import lysa.ui.window_snapshot;
 
 export namespace lysa::ui {
 
@@ -69,6 +76,18 @@ export namespace lysa::ui {
          */
         void setStyle(const std::shared_ptr<Style>& style);
 
+        /**
+         * Changes several style options at once then redraws the Window.
+         * @param options Options to change.
+         */
+        void applyTheme(const Style::Options& options);
+
+        /**
+         * Switches to a precompiled theme then redraws the Window.
+         * @param theme A snapshot compiled by the current style.
+         */
+        void setTheme(const std::shared_ptr<const Style::ThemeSnapshot>& theme);
+
         /**
          * Returns the root widget.
          *
@@ -107,6 +126,26 @@ export namespace lysa::ui {
                 resource);
         }
 
+        /**
+         * Creates & adds a child widget using a resource description parsed at compile time.
+         * @tparam T The type of the widget to create.
+         * @tparam Args The types of the arguments to pass to the widget constructor.
+         * @param resource Resource description, usually `res<"...">`.
+         * @param alignment Placement alignment.
+         * @param args Arguments to pass to the widget constructor.
+         * @return Shared pointer to the created widget.
+         */
+        template<typename T, typename... Args>
+        std::shared_ptr<T> create(
+            const ResourceDescriptor & resource,
+            const Alignment alignment,
+            Args&&... args) {
+            return getWidget().add(
+                std::make_shared<T>(ctx, std::forward<Args>(args)...),
+                alignment,
+                resource);
+        }
+
         /**
          * Creates & adds a child widget.
          * @tparam T The type of the widget to create.
@@ -144,6 +183,31 @@ export namespace lysa::ui {
             return getWidget().add(child, alignment, resource, overlap);
         }
 
+        /**
+         * Creates all the widgets of a layout and adds them to the main widget.
+         *
+         * The widgets are allocated in one sweep, each distinct resource description is interned once,
+         * and the tree is laid out once at the end instead of after each added widget.
+         * An invalid layout throws an Exception before any widget is added to the Window.
+         * @param layoutFile The layout to instantiate.
+         * @return The created widgets, in the layout nodes order (see LayoutFile::indexOf()).
+         */
+        std::vector<std::shared_ptr<Widget>> createLayout(const LayoutFile& layoutFile);
+
+        /**
+         * Saves the children of the main widget, see WindowSnapshot.
+         */
+        WindowSnapshot saveSnapshot() const;
+
+        /**
+         * Replaces the children of the main widget with the widgets of a snapshot.
+         *
+         * The saved geometry is used as is if the Window size did not change, otherwise the widgets are laid out.
+         * @param snapshot A snapshot returned by saveSnapshot() or WindowSnapshot::deserialize().
+         * @return The created widgets, in the snapshot layout nodes order.
+         */
+        std::vector<std::shared_ptr<Widget>> restoreSnapshot(const WindowSnapshot& snapshot);
+
         /**
          * Removes a child widget.
          */
@@ -151,11 +215,49 @@ export namespace lysa::ui {
             getWidget().remove(child);
         }
 
+        /**
+         * Returns a widget of the Window by its id.
+         * @return The widget, or nullptr if not found or removed from the Window.
+         */
+        std::shared_ptr<Widget> findById(const unique_id id) const { return widgetsIndex.find(id); }
+
+        /**
+         * Returns a widget of the Window by its id, with a given type.
+         * @return The widget, or nullptr if not found, removed from the Window or of another type.
+         */
+        template<typename T>
+        std::shared_ptr<T> find(const unique_id id) const { return std::dynamic_pointer_cast<T>(findById(id)); }
+
+        WidgetIndex& _getIndex() { return widgetsIndex; }
+
         /**
          * Changes the focus to a specific widget.
          */
         void setFocusedWidget(const std::shared_ptr<Widget>& widget);
 
+        void _clearFocusedWidget() { focusedWidget = nullptr; }
+
+        /**
+         * Moves the keyboard focus to the next focusable widget, in the order of the widgets tree.
+         * Called when the Tab key is pressed.
+         * @return The newly focused widget, or nullptr if the Window has no focusable widget.
+         */
+        std::shared_ptr<Widget> focusNext() { return _focusStep(focusedWidget.get(), 1); }
+
+        /**
+         * Moves the keyboard focus to the previous focusable widget. Called when Shift-Tab is pressed.
+         * @return The newly focused widget, or nullptr if the Window has no focusable widget.
+         */
+        std::shared_ptr<Widget> focusPrevious() { return _focusStep(focusedWidget.get(), -1); }
+
+        std::shared_ptr<Widget> _focusStep(const Widget* from, int32 step);
+
+        void _invalidateFocusChain() { focusChainValid = false; }
+
+        void _movedWidget() { positionsEpoch += 1; }
+
+        auto _getPositionsEpoch() const { return positionsEpoch; }
+
         /**
          * Returns the width of the client area.
          */
@@ -376,7 +478,13 @@ export namespace lysa::ui {
 
         void setTextColor(const float4& color) { textColor = color; }
 
-        void refresh() const;
+        /**
+         * Forces a redrawing of the UI at the start of the next frame.
+         * @param location Call site, recorded when the refresh tracing is enabled.
+         */
+        void refresh(const std::source_location& location = std::source_location::current()) const;
+
+        void _refresh(unique_id source, const std::source_location& location) const;
 
         void eventCreate();
 
@@ -404,9 +512,10 @@ export namespace lysa::ui {
 
         void eventLostFocus();
 
-        void draw() const;
+        void draw(DrawSink& sink) const;
 
         friend class WindowManager;
+        friend class UpdateScope;
 
         void attach(WindowManager* windowManager);
 
@@ -414,6 +523,32 @@ export namespace lysa::ui {
 
         WindowManager& getWindowManager() const { return *windowManager; }
 
+        FrameStatsCollector* _getFrameStats() const { return frameStats; }
+
+        RefreshTracer* _getRefreshTracer() const {
+            return refreshTracer && refreshTracer->isEnabled() ? refreshTracer : nullptr;
+        }
+
+        /**
+         * Returns the visual generation of the Window, advanced each time the drawn state of one of its widgets changes.
+         */
+        auto getGeneration() const { return generation; }
+
+        /**
+         * Returns true if an UpdateScope is open on the Window.
+         */
+        bool isUpdating() const { return updateDepth > 0; }
+
+        bool _deferLayout() {
+            if (updateDepth == 0) { return false; }
+            layoutDeferred = true;
+            return true;
+        }
+
+        void _deferEvent(const std::string& type, std::any payload, unique_id source) {
+            deferredEvents.push_back({type, std::move(payload), source});
+        }
+
     private:
         Context& ctx;
         Rect rect;
@@ -424,17 +559,106 @@ export namespace lysa::ui {
         std::shared_ptr<Style> layout{nullptr};
         std::shared_ptr<Widget> widget{nullptr};
         std::shared_ptr<Widget> focusedWidget{nullptr};
+        // Enabled, visible & focusable widgets in tree order, rebuilt after a change of the tree
+        std::vector<Widget*> focusChain;
+        bool focusChainValid{false};
+        bool shiftPressed{false};
+        // Advanced when a widget moves, the widgets positions are cached for one epoch
+        uint32 positionsEpoch{1};
+        WidgetIndex widgetsIndex;
         float transparency{1.0};
         float4 textColor{0.0f, 0.0f, 0.0f, 1.0f};
         uint32 resizeableBorders{RESIZEABLE_NONE};
         WindowManager* windowManager{nullptr};
+        FrameStatsCollector* frameStats{nullptr};
+        RefreshTracer* refreshTracer{nullptr};
         bool visibilityChanged{false};
         bool visible{true};
         bool visibilityChange{false};
         std::shared_ptr<Font> font{nullptr};
         float fontScale{1.0f};
+        // UpdateScope state
+        struct DeferredEvent {
+            std::string type;
+            std::any payload;
+            unique_id source;
+        };
+        uint32 updateDepth{0};
+        bool layoutDeferred{false};
+        mutable bool refreshDeferred{false};
+        std::vector<DeferredEvent> deferredEvents;
+        mutable uint32 generation{0};
+        uint32 dispatchDepth{0};
+
+        // Dispatches an input event to the widgets : the refreshes are recorded but the
+        // UI is redrawn only if a generation advanced when the outermost dispatch ends
+        class Dispatch {
+        public:
+            explicit Dispatch(Window& window);
+            ~Dispatch();
+        private:
+            Window& window;
+            const uint32 generation;
+        };
+
+        void beginUpdate() { updateDepth += 1; }
+
+        // Closes an UpdateScope, applies the deferred layout, refresh & events when closing the outermost one
+        void endUpdate();
 
         void unFreeze(const std::shared_ptr<Widget> &);
+
+        void emit(const std::string& type, std::any payload);
+
+        // Creates & attaches the widgets of a layout, leaving them & the main widget frozen.
+        // Throws before attaching any widget if the layout is invalid.
+        std::vector<std::shared_ptr<Widget>> instantiate(const LayoutFile& layoutFile);
+
+        void saveWidget(WindowSnapshot& snapshot, const Widget& widget, uint32 parent) const;
+
+        static void saveGeometry(WindowSnapshot& snapshot, const Widget& widget, bool withChildren);
+
+        static void collectWidgets(Widget& widget, std::vector<Widget*>& widgets);
+
+        void buildFocusChain(Widget& widget);
+    };
+
+    /**
+     * Groups several changes of the widgets of a Window.
+     *
+     * While the scope is open the layouts, the refreshes and the UI events triggered by the
+     * widgets of the Window are deferred. When the outermost scope is closed, the Window is
+     * laid out once, refreshed once, and the deferred events are pushed in their original order.
+     * Scopes can be nested, and are closed even when leaving with an exception.
+     * ```
+     * {
+     *     auto scope = UpdateScope{window};
+     *     name->setText(character.name);
+     *     level->setValue(character.level);
+     * }
+     * ```
+     */
+    class UpdateScope {
+    public:
+        /**
+         * Opens a scope for all the widgets of a Window.
+         */
+        explicit UpdateScope(Window& window);
+
+        /**
+         * Opens a scope for all the widgets of the Window of a widget.
+         * @param widget A widget added to a Window.
+         */
+        explicit UpdateScope(const Widget& widget);
+
+        ~UpdateScope() noexcept(false);
+
+        UpdateScope(const UpdateScope&) = delete;
+        UpdateScope& operator=(const UpdateScope&) = delete;
+
+    private:
+        Window* window;
+        const int exceptions;
     };
 }
 
@@ -7,6 +7,7 @@
 module lysa.ui.window_manager;
 
 import lysa;
+import lysa.ui.trace;
 
 namespace lysa::ui {
 
@@ -31,6 +32,7 @@ namespace lysa::ui {
     }
 
     WindowManager::~WindowManager() {
+        setPipelined(false);
         for (const auto& window: windows) {
             window->eventDestroy();
         }
@@ -38,15 +40,170 @@ namespace lysa::ui {
     }
 
     void WindowManager::drawFrame() {
+        auto span = Trace::Scope{"WindowManager::drawFrame"};
+        if (drawWorker.joinable()) {
+            // Sends the draw list built during the previous frame
+            sync();
+            if (drawListReady) {
+                drawListReady = false;
+                drawList.replay(*drawSink);
+            }
+            frameStats.nextFrame();
+            refreshTracer.nextFrame();
+        }
+        // Before locking, the commands can add or remove windows
+        commands.drain();
+        updateWidgets();
+        applyResize();
         auto lock = std::lock_guard(windowsMutex);
-        for(const auto&window : removedWindows) {
+        {
+            auto windowsScope = FrameStatsCollector::Scope{&frameStats, &FrameStats::windowsTime};
+            processWindows();
+        }
+        if (needRedraw) {
+            needRedraw = false;
+            if (drawWorker.joinable()) {
+                auto pipelineLock = std::lock_guard(pipelineMutex);
+                drawListRequested = true;
+                pipelineCondition.notify_all();
+            } else {
+                drawWindows(*drawSink);
+            }
+        }
+        if (!drawWorker.joinable()) {
+            frameStats.nextFrame();
+            refreshTracer.nextFrame();
+        }
+    }
+
+    void WindowManager::updateWidgets() {
+        const auto now = std::chrono::steady_clock::now();
+        const auto delta = lastUpdateTime == std::chrono::steady_clock::time_point{} ?
+            0.0f :
+            std::chrono::duration<float>(now - lastUpdateTime).count();
+        lastUpdateTime = now;
+        if (bindings.getSize() == 0 && tweens.getSize() == 0) { return; }
+        {
+            // The updated widgets events handlers can add windows
+            auto lock = std::lock_guard(windowsMutex);
+            updatedWindows.assign(windows.begin(), windows.end());
+        }
+        for (const auto& window : updatedWindows) {
+            window->beginUpdate();
+        }
+        try {
+            bindings.update();
+            tweens.update(delta);
+        } catch (...) {
+            for (const auto& window : updatedWindows) {
+                try { window->endUpdate(); } catch (...) { }
+            }
+            updatedWindows.clear();
+            throw;
+        }
+        for (const auto& window : updatedWindows) {
+            window->endUpdate();
+        }
+        updatedWindows.clear();
+    }
+
+    void WindowManager::applyResize() {
+        if (!resizePending) { return; }
+        resizePending = false;
+        if (resizedWindow) { resizedWindow->setRect(resizeRect); }
+    }
+
+    void WindowManager::updateMouseCursor(const MouseCursor cursor) {
+        if (cursor == appliedCursor) { return; }
+        appliedCursor = cursor;
+        renderingWindow.setMouseCursor(cursor);
+    }
+
+    void WindowManager::drawWindows(DrawSink& sink) {
+        auto drawScope = FrameStatsCollector::Scope{&frameStats, &FrameStats::drawTime};
+        sink.restart();
+        for (const auto& window: windows) {
+            window->draw(sink);
+        }
+        if (drawHeatmap) {
+            sink.setTransparency(0.0f);
+            for (const auto& window: windows) {
+                if (!window->isVisible() || !window->widget) { continue; }
+                sink.setTranslate({window->rect.x, window->rect.y});
+                drawWidgetHeat(sink, *window->widget);
+            }
+        }
+    }
+
+    void WindowManager::drawWidgetHeat(DrawSink& sink, Widget& widget) {
+        if (!widget.isVisible()) { return; }
+        const auto color = refreshTracer.getHeatColor(widget.id);
+        if (color.a > 0.0f) {
+            sink.setPenColor(color);
+            sink.drawFilledRect(widget.getRect());
+        }
+        for (const auto& child : widget._getChildren()) {
+            drawWidgetHeat(sink, *child);
+        }
+    }
+
+    void WindowManager::setPipelined(const bool enable) {
+        if (enable == drawWorker.joinable()) { return; }
+        if (enable) {
+            drawWorker = std::jthread([this](const std::stop_token& stop) { drawLoop(stop); });
+        } else {
+            sync();
+            drawWorker.request_stop();
+            drawWorker.join();
+            // The last list was not sent, draws it again synchronously
+            drawListReady = false;
+            needRedraw = true;
+        }
+    }
+
+    void WindowManager::sync() {
+        auto lock = std::unique_lock(pipelineMutex);
+        pipelineCondition.wait(lock, [this] { return !drawListRequested; });
+    }
+
+    void WindowManager::drawLoop(const std::stop_token& stop) {
+        auto lock = std::unique_lock(pipelineMutex);
+        while (pipelineCondition.wait(lock, stop, [this] { return drawListRequested; })) {
+            lock.unlock();
+            {
+                auto windowsLock = std::lock_guard(windowsMutex);
+                drawWindows(drawList);
+            }
+            lock.lock();
+            drawListRequested = false;
+            drawListReady = true;
+            pipelineCondition.notify_all();
+        }
+    }
+
+    void WindowManager::setRefreshTracing(const bool enable, const bool heatmap) {
+        // The worker reads the tracer & the heatmap flag
+        if (drawWorker.joinable()) { sync(); }
+        refreshTracer.setEnabled(enable);
+        drawHeatmap = enable && heatmap;
+        needRedraw = true;
+    }
+
+    void WindowManager::processWindows() {
+        {
+            // Separate lock, the windows events can remove windows
+            auto lock = std::lock_guard(removedWindowsMutex);
+            std::swap(removedWindows, removingWindows);
+        }
+        for(const auto&window : removingWindows) {
             window->detach();
             if (window->isVisible()) { window->eventHide(); }
             window->eventDestroy();
             windows.remove(window);
+            frameStats.count(&FrameStats::windowsRemoved);
             needRedraw = true;
         }
-        removedWindows.clear();
+        removingWindows.clear();
         for (auto& window: windows) {
             if (window->visibilityChanged) {
                 window->visibilityChanged = false;
@@ -71,15 +228,16 @@ namespace lysa::ui {
                 }
             }
         }
-        if (!needRedraw) { return; }
-        needRedraw = false;
-        renderer.restart();
-        for (const auto& window: windows) {
-            window->draw();
-        }
+    }
+
+    void WindowManager::setDrawSink(DrawSink* sink) {
+        drawSink = sink ? sink : &rendererDrawSink;
+        needRedraw = true;
     }
 
     std::shared_ptr<Window> WindowManager::add(const std::shared_ptr<Window> &window) {
+        if (drawWorker.joinable()) { sync(); }
+        auto windowsScope = FrameStatsCollector::Scope{&frameStats, &FrameStats::windowsTime};
         {
             auto lock = std::lock_guard(windowsMutex);
             windows.push_back(window);
@@ -87,15 +245,28 @@ namespace lysa::ui {
         }
         window->eventCreate();
         if (window->isVisible()) { window->eventShow(); }
+        frameStats.count(&FrameStats::windowsAdded);
         needRedraw = true;
         return window;
     }
 
+    std::shared_ptr<Widget> WindowManager::findById(const unique_id id) const {
+        for (const auto& window : windows) {
+            if (auto widget = window->findById(id)) { return widget; }
+        }
+        return nullptr;
+    }
+
     void WindowManager::remove(const std::shared_ptr<Window>&window) {
+        auto lock = std::lock_guard(removedWindowsMutex);
         removedWindows.push_back(window);
     }
 
     bool WindowManager::onInput(const InputEvent &inputEvent) {
+        auto span = Trace::Scope{"WindowManager::onInput"};
+        if (drawWorker.joinable()) { sync(); }
+        auto inputScope = FrameStatsCollector::Scope{&frameStats, &FrameStats::inputTime};
+        frameStats.count(&FrameStats::inputEvents);
         if (inputEvent.type == InputEventType::KEY) {
             const auto &keyInputEvent = std::get<InputEventKey>(inputEvent.data);
             if ((focusedWindow != nullptr) && (focusedWindow->isVisible())) {
@@ -120,7 +291,7 @@ namespace lysa::ui {
                 const auto resizeDeltaY = scaleY * resizeDelta;
                 if (resizedWindow != nullptr) {
                     if (resizingWindow) {
-                        Rect rect = resizedWindow->getRect();
+                        Rect rect = resizePending ? resizeRect : resizedWindow->getRect();
                         if (currentCursor == MouseCursor::RESIZE_H) {
                             const auto lx = x - rect.x;
                             if (resizingWindowOriginBorder) {
@@ -138,13 +309,19 @@ namespace lysa::ui {
                                 rect.height = ly;
                             }
                         }
-                        resizedWindow->setRect(rect);
-                        renderingWindow.setMouseCursor(currentCursor);
+                        if (throttledResizing) {
+                            // Laid out once at the start of the next frame
+                            resizeRect = rect;
+                            resizePending = true;
+                        } else {
+                            resizedWindow->setRect(rect);
+                        }
+                        updateMouseCursor(currentCursor);
                         return true;
                     }
                     currentCursor = MouseCursor::ARROW;
                     resizedWindow = nullptr;
-                    renderingWindow.setMouseCursor(currentCursor);
+                    updateMouseCursor(currentCursor);
                 }
                 for (const auto& window: windows) {
                     auto consumed = false;
@@ -175,7 +352,7 @@ namespace lysa::ui {
                                                                  }
                         }
                         if (resizedWindow != nullptr) {
-                            renderingWindow.setMouseCursor(currentCursor);
+                            updateMouseCursor(currentCursor);
                             return true;
                         }
                         consumed |= window->eventMouseMove(mouseEvent.buttonsState, lx, ly);
@@ -193,11 +370,12 @@ namespace lysa::ui {
                             resizingWindow = true;
                         } else if ((mouseInputEvent.button == MouseButton::LEFT) &&
                                    (!mouseInputEvent.pressed)) {
+                            applyResize();
                             currentCursor = MouseCursor::ARROW;
                             resizedWindow = nullptr;
                             resizingWindow = false;
                         }
-                    renderingWindow.setMouseCursor(currentCursor);
+                    updateMouseCursor(currentCursor);
                     return true;
                 }
                 for (const auto& window: windows) {
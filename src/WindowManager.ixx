@@ -13,6 +13,15 @@ import lysa.rect;
 import lysa.renderers.vector_2d;
 import lysa.resources.font;
 import lysa.resources.rendering_window;
+import lysa.types;
+import lysa.ui.bindings;
+import lysa.ui.command_queue;
+import lysa.ui.draw_recorder;
+import lysa.ui.draw_sink;
+import lysa.ui.frame_stats;
+import lysa.ui.refresh_tracer;
+import lysa.ui.tweens;
+import lysa.ui.widget;
 import lysa.ui.window;
 
 export namespace lysa::ui {
@@ -60,6 +69,51 @@ export namespace lysa::ui {
          */
         void remove(const std::shared_ptr<Window>& window);
 
+        /**
+         * Posts a call to a widget setter, applied at the start of the next frame.
+         *
+         * This is the only way to update widgets from other threads than the UI thread :
+         * `ui.post<&Text::setText>(healthText, "100")`. When a setter of a widget is posted
+         * several times during a frame only the latest value is applied.
+         * @tparam setter The setter.
+         * @param widget The target widget, ignored if destroyed before the next frame.
+         * @param args The setter arguments, copied.
+         */
+        template<auto setter, typename T, typename... Args>
+        void post(const std::shared_ptr<T>& widget, Args&&... args) {
+            commands.post<setter>(widget, std::forward<Args>(args)...);
+        }
+
+        /**
+         * Posts a function called by the UI thread at the start of the next frame. Can be called from any thread.
+         */
+        void post(std::function<void()> function) {
+            commands.post(std::move(function));
+        }
+
+        /**
+         * Returns the widgets bindings, updated once per frame before the layout & the drawing.
+         */
+        Bindings& getBindings() { return bindings; }
+
+        /**
+         * Returns the widgets animations, updated once per frame before the layout & the drawing.
+         */
+        Tweens& getTweens() { return tweens; }
+
+        /**
+         * Returns a widget of any managed Window by its id.
+         * @return The widget, or nullptr if not found.
+         */
+        std::shared_ptr<Widget> findById(unique_id id) const;
+
+        /**
+         * Returns a widget of any managed Window by its id, with a given type.
+         * @return The widget, or nullptr if not found or of another type.
+         */
+        template<typename T>
+        std::shared_ptr<T> find(const unique_id id) const { return std::dynamic_pointer_cast<T>(findById(id)); }
+
         /**
          * Returns the default font loaded at creation.
          */
@@ -82,14 +136,66 @@ export namespace lysa::ui {
 
         /**
          * Forces a redrawing of all the UI at the start of the next frame.
+         * @param location Call site, recorded when the refresh tracing is enabled.
          */
-        void refresh() { needRedraw = true; }
+        void refresh(const std::source_location& location = std::source_location::current()) {
+            _refresh(INVALID_ID, location);
+        }
+
+        void _refresh(const unique_id source, const std::source_location& location) {
+            _traceRefresh(source, location);
+            needRedraw = true;
+        }
+
+        void _traceRefresh(const unique_id source, const std::source_location& location) {
+            frameStats.count(&FrameStats::refreshes);
+            if (refreshTracer.isEnabled()) { refreshTracer.refresh(source, location); }
+        }
+
+        void _redraw() { needRedraw = true; }
 
         /**
          * Returns the 2D renderer used by the manager.
          */
         Vector2DRenderer& getRenderer() { return renderer; }
 
+        /**
+         * Returns the destination of the UI drawing primitives.
+         */
+        DrawSink& getDrawSink() const { return *drawSink; }
+
+        /**
+         * Changes the destination of the UI drawing primitives, for example a DrawRecorder.
+         * @param sink The new destination, or nullptr to draw with the manager renderer.
+         */
+        void setDrawSink(DrawSink* sink);
+
+        /**
+         * Returns the timings & counters of the last complete frame.
+         *
+         * Values are always zero if the library was compiled without LYSA_UI_FRAME_STATS.
+         */
+        const FrameStats& getFrameStats() const { return frameStats.getPreviousStats(); }
+
+        /**
+         * Returns the timings & counters of the frame in progress.
+         */
+        const FrameStats& getCurrentFrameStats() const { return frameStats.getStats(); }
+
+        FrameStatsCollector& _getFrameStats() { return frameStats; }
+
+        /**
+         * Starts or stops recording the refresh requests & the layout passes.
+         * @param enable Records the requests, see getRefreshTracer().
+         * @param heatmap Draws each widget tinted by its refreshes (red) and layouts (green) counts over the UI.
+         */
+        void setRefreshTracing(bool enable, bool heatmap = false);
+
+        /**
+         * Returns the refresh requests records.
+         */
+        RefreshTracer& getRefreshTracer() { return refreshTracer; }
+
         /**
          * Returns the resize delta for window resizing.
          */
@@ -100,11 +206,54 @@ export namespace lysa::ui {
          */
         void setEnableWindowResizing(const bool enable) { enableWindowResizing = enable; }
 
+        /**
+         * Enables or disables the throttling of the windows resizing by the user. Enabled by default.
+         *
+         * When enabled, dragging a window border lays out the window at most once per frame,
+         * at the start of drawFrame(), and once more with the final size when the border is released.
+         */
+        void setThrottledResizing(const bool throttled) { throttledResizing = throttled; }
+
         /**
          * Draws one frame of the UI.
          */
         void drawFrame();
 
+        /**
+         * Enables or disables the pipelined drawing.
+         *
+         * When pipelined, drawFrame() only applies the posted commands and the windows changes
+         * then returns, the styles draw the windows into a draw list on a worker thread while the
+         * main loop continues. The next drawFrame() waits for the worker and sends the list to the
+         * draw sink, the UI being displayed with one frame of latency.
+         *
+         * Only the drawing is offloaded : the layout (windows resizing & widgets relayouts) still
+         * runs on the main thread, in drawFrame() and in the events handlers.
+         *
+         * While the worker is drawing, between the return of drawFrame() and the next drawFrame() or onInput() :
+         * - post() and remove() are safe from any thread,
+         * - add(), create() and setRefreshTracing() are safe, they wait for the worker,
+         * - getFrameStats() is safe, the worker only writes the stats of the frame in progress,
+         * - getCurrentFrameStats(), getRefreshTracer(), findById(), find() and all the other Window and
+         *   Widget methods must not be called without calling sync() first.
+         *
+         * The posted commands, and the events handlers called from drawFrame() and onInput(), run after
+         * the wait for the worker. Events handlers called by the application, for example by a
+         * Widget method, follow the rules above.
+         */
+        void setPipelined(bool enable);
+
+        /**
+         * Returns true if the drawing is pipelined.
+         */
+        bool isPipelined() const { return drawWorker.joinable(); }
+
+        /**
+         * Waits for the pipelined drawing of the current frame, if any.
+         * After this call the windows & widgets can be modified until the next drawFrame().
+         */
+        void sync();
+
         /**
          * Handles an input event.
          * @param inputEvent The input event to process.
@@ -117,10 +266,14 @@ export namespace lysa::ui {
         Context& ctx;
         RenderingWindow& renderingWindow;
         Vector2DRenderer renderer;
+        RendererDrawSink rendererDrawSink{renderer};
+        DrawSink* drawSink{&rendererDrawSink};
         std::shared_ptr<Font> defaultFont;
         std::list<std::shared_ptr<Window>> windows;
         std::mutex windowsMutex;
+        std::mutex removedWindowsMutex;
         std::vector<std::shared_ptr<Window>> removedWindows{};
+        std::vector<std::shared_ptr<Window>> removingWindows{};
         std::shared_ptr<Window> focusedWindow{nullptr};
         std::shared_ptr<Window> resizedWindow{nullptr};
         bool needRedraw{false};
@@ -128,7 +281,44 @@ export namespace lysa::ui {
         bool resizingWindow{false};
         bool resizingWindowOriginBorder{false};
         MouseCursor currentCursor{MouseCursor::ARROW};
+        MouseCursor appliedCursor{MouseCursor::ARROW};
+        bool throttledResizing{true};
+        bool resizePending{false};
+        Rect resizeRect;
         float fontScale;
         float4 textColor{1.0f};
+        FrameStatsCollector frameStats;
+        CommandQueue commands;
+        Bindings bindings;
+        Tweens tweens;
+        std::chrono::steady_clock::time_point lastUpdateTime{};
+        std::vector<std::shared_ptr<Window>> updatedWindows;
+        // Pipelined drawing, see setPipelined()
+        DrawRecorder drawList;
+        bool drawListRequested{false};
+        bool drawListReady{false};
+        std::mutex pipelineMutex;
+        std::condition_variable_any pipelineCondition;
+        std::jthread drawWorker;
+        RefreshTracer refreshTracer;
+        bool drawHeatmap{false};
+
+        // Removes the windows & applies the visibility changes requested since the last frame
+        void processWindows();
+
+        // Applies the size of the window resized by the user since the last frame
+        void applyResize();
+
+        // Changes the mouse cursor only if different from the last one set
+        void updateMouseCursor(MouseCursor cursor);
+
+        // Updates the bound & animated widgets with one layout & one refresh per window
+        void updateWidgets();
+
+        void drawWindows(DrawSink& sink);
+
+        void drawWidgetHeat(DrawSink& sink, Widget& widget);
+
+        void drawLoop(const std::stop_token& stop);
     };
 }
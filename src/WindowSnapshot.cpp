@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+module lysa.ui.window_snapshot;
+
+import lysa.exception;
+
+namespace lysa::ui {
+
+    std::vector<char> WindowSnapshot::serialize() const {
+        const auto binaryLayout = layout.serialize();
+        auto header = Header{
+            .magic = MAGIC,
+            .version = VERSION,
+            .width = width,
+            .height = height,
+            .layoutOffset = sizeof(Header),
+            .layoutSize = static_cast<uint32>(binaryLayout.size()),
+            .geometriesCount = static_cast<uint32>(geometries.size()),
+        };
+        // Keeps the following arrays aligned
+        header.statesOffset = (header.layoutOffset + header.layoutSize + 3) & ~3u;
+        header.geometriesOffset = header.statesOffset + static_cast<uint32>(states.size() * sizeof(State));
+        header.size = header.geometriesOffset + header.geometriesCount * sizeof(Geometry);
+
+        auto result = std::vector<char>(header.size);
+        std::memcpy(result.data(), &header, sizeof(Header));
+        std::memcpy(result.data() + header.layoutOffset, binaryLayout.data(), binaryLayout.size());
+        std::memcpy(result.data() + header.statesOffset, states.data(), states.size() * sizeof(State));
+        std::memcpy(result.data() + header.geometriesOffset, geometries.data(), geometries.size() * sizeof(Geometry));
+        return result;
+    }
+
+    WindowSnapshot WindowSnapshot::deserialize(const std::span<const char> data) {
+        auto header = Header{};
+        if (data.size() < sizeof(Header)) { throw Exception("Invalid window snapshot"); }
+        std::memcpy(&header, data.data(), sizeof(Header));
+        const auto inside = [&](const std::uint64_t offset, const std::uint64_t length) {
+            return offset <= data.size() && length <= data.size() - offset;
+        };
+        if (header.magic != MAGIC || header.version != VERSION || header.size != data.size() ||
+            !inside(header.layoutOffset, header.layoutSize)) {
+            throw Exception("Invalid window snapshot");
+        }
+
+        auto snapshot = WindowSnapshot{};
+        snapshot.width = header.width;
+        snapshot.height = header.height;
+        snapshot.layout = LayoutFile::deserialize(data.subspan(header.layoutOffset, header.layoutSize));
+        const auto statesCount = snapshot.layout.getNodes().size();
+        if (!inside(header.statesOffset, statesCount * sizeof(State)) ||
+            !inside(header.geometriesOffset, std::uint64_t{header.geometriesCount} * sizeof(Geometry))) {
+            throw Exception("Invalid window snapshot");
+        }
+        snapshot.states.resize(statesCount);
+        std::memcpy(snapshot.states.data(), data.data() + header.statesOffset, statesCount * sizeof(State));
+        snapshot.geometries.resize(header.geometriesCount);
+        std::memcpy(snapshot.geometries.data(), data.data() + header.geometriesOffset, header.geometriesCount * sizeof(Geometry));
+        return snapshot;
+    }
+
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+export module lysa.ui.window_snapshot;
+
+import std;
+import lysa.types;
+import lysa.ui.layout_file;
+
+export namespace lysa::ui {
+
+    /**
+     * Saved state of the widgets of a Window, produced by Window::saveSnapshot()
+     * and restored by Window::restoreSnapshot().
+     *
+     * A snapshot holds the widgets tree as a LayoutFile, the state of each widget
+     * (visibility, check state, values) and the geometry of every widget of the tree,
+     * including the children created internally by the widgets, to restore the window
+     * without running the layout when its size did not change.
+     *
+     * Images and tree view items are not saved.
+     */
+    class WindowSnapshot {
+    public:
+        /**
+         * State flags.
+         */
+        enum Flags : uint32 {
+            HIDDEN   = 0b0001, //! Widget hidden
+            DISABLED = 0b0010, //! Widget disabled
+            CHECKED  = 0b0100, //! Check widget in the CHECK state
+        };
+
+        /**
+         * Binary form header.
+         */
+        struct Header {
+            uint32 magic;            //! MAGIC
+            uint32 version;          //! VERSION
+            uint32 size;             //! Total size
+            float width;             //! Window width when saved
+            float height;            //! Window height when saved
+            uint32 layoutOffset;     //! Offset of the binary layout
+            uint32 layoutSize;       //! Size of the binary layout
+            uint32 statesOffset;     //! Offset of the first State, one per layout node
+            uint32 geometriesCount;  //! Number of Geometry
+            uint32 geometriesOffset; //! Offset of the first Geometry
+        };
+
+        /**
+         * State of a widget, in the layout nodes order.
+         */
+        struct State {
+            uint32 flags;  //! State flags
+            float min;     //! Minimum value of value selection widgets
+            float max;     //! Maximum value of value selection widgets
+            float value;   //! Current value of value selection widgets
+            float step;    //! Step of value selection widgets
+        };
+
+        /**
+         * Geometry of a widget, in the depth-first order of the full widgets tree.
+         */
+        struct Geometry {
+            float x;              //! Position
+            float y;              //! Position
+            float width;          //! Size
+            float height;         //! Size
+            float defaultX;       //! Position before layout
+            float defaultY;       //! Position before layout
+            float defaultWidth;   //! Size before layout
+            float defaultHeight;  //! Size before layout
+            float hborder;        //! Horizontal border size
+            float vborder;        //! Vertical border size
+        };
+
+        static constexpr uint32 MAGIC{0x5349554c}; //! "LUIS"
+        static constexpr uint32 VERSION{1};
+
+        /**
+         * Reads the binary form of a snapshot.
+         * @param data Content of a binary snapshot, as returned by serialize().
+         */
+        static WindowSnapshot deserialize(std::span<const char> data);
+
+        /**
+         * Returns the compact binary form of the snapshot.
+         */
+        std::vector<char> serialize() const;
+
+        /**
+         * Returns the widgets tree.
+         */
+        const LayoutFile& getLayout() const { return layout; }
+
+        /**
+         * Returns the widgets states, in the layout nodes order.
+         */
+        std::span<const State> getStates() const { return states; }
+
+        /**
+         * Returns the widgets geometries, in the depth-first order of the full widgets tree.
+         */
+        std::span<const Geometry> getGeometries() const { return geometries; }
+
+        /**
+         * Returns the Window width when saved.
+         */
+        auto getWidth() const { return width; }
+
+        /**
+         * Returns the Window height when saved.
+         */
+        auto getHeight() const { return height; }
+
+        friend class Window;
+
+    private:
+        float width{0};
+        float height{0};
+        LayoutFile layout;
+        std::vector<State> states;
+        std::vector<Geometry> geometries;
+    };
+
+}